@@ -0,0 +1,564 @@
+/**
+ * =============================================================================
+ * CS2Fixes
+ * Copyright (C) 2023-2025 Source2ZE
+ * =============================================================================
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License, version 3.0, as published by the
+ * Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Offline gamedata validator and signature scan benchmark
+// Maps the game's binaries from disk and resolves every linux entry of cs2fixes.games.txt with the plugin's own scanner,
+// so gamedata can be checked against a new game build without running a server
+//
+// Usage: gamedatacheck [--game csgo] [--iterations N] <cs2fixes.games.txt> <library>=<path> [<library>=<path> ...]
+// e.g.   gamedatacheck gamedata/cs2fixes.games.txt server=game/csgo/bin/linuxsteamrt64/libserver.so engine=game/bin/linuxsteamrt64/libengine2.so
+
+#include "sigscan.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <elf.h>
+#include <fcntl.h>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+struct KeyValue_t
+{
+	std::string m_strKey;
+	std::string m_strValue;
+	std::vector<KeyValue_t> m_vecChildren;
+
+	const KeyValue_t* FindKey(const std::string& strKey) const
+	{
+		for (const auto& child : m_vecChildren)
+			if (child.m_strKey == strKey)
+				return &child;
+
+		return nullptr;
+	}
+
+	std::string GetString(const std::string& strKey) const
+	{
+		const KeyValue_t* pChild = FindKey(strKey);
+		return pChild ? pChild->m_strValue : "";
+	}
+};
+
+// Just enough of the KeyValues text format for gamedata files
+// Escape sequences are deliberately left alone, signatures are "\x48\x89..." strings that the plugin parses itself
+class CKeyValuesReader
+{
+public:
+	CKeyValuesReader(const std::string& strText) :
+		m_strText(strText), m_nPos(0)
+	{
+		// Skip the UTF-8 BOM, the gamedata is saved with one
+		if (m_strText.compare(0, 3, "\xEF\xBB\xBF") == 0)
+			m_nPos = 3;
+	}
+
+	bool Parse(KeyValue_t& root)
+	{
+		std::string strToken;
+
+		while (NextToken(strToken))
+		{
+			if (strToken == "{" || strToken == "}")
+			{
+				fprintf(stderr, "Unexpected '%s' on line %i, expected a key\n", strToken.c_str(), GetLine());
+				return false;
+			}
+
+			KeyValue_t& child = root.m_vecChildren.emplace_back();
+			child.m_strKey = strToken;
+
+			if (!ParseValue(child))
+				return false;
+		}
+
+		return true;
+	}
+
+private:
+	bool ParseValue(KeyValue_t& kv)
+	{
+		std::string strToken;
+
+		if (!NextToken(strToken))
+		{
+			fprintf(stderr, "Unexpected end of file, missing value for %s\n", kv.m_strKey.c_str());
+			return false;
+		}
+
+		if (strToken == "}")
+		{
+			fprintf(stderr, "Unexpected '}' on line %i, missing value for %s\n", GetLine(), kv.m_strKey.c_str());
+			return false;
+		}
+
+		if (strToken != "{")
+		{
+			kv.m_strValue = strToken;
+			return true;
+		}
+
+		while (NextToken(strToken))
+		{
+			if (strToken == "}")
+				return true;
+
+			if (strToken == "{")
+			{
+				fprintf(stderr, "Unexpected '{' on line %i in %s, expected a key\n", GetLine(), kv.m_strKey.c_str());
+				return false;
+			}
+
+			KeyValue_t& child = kv.m_vecChildren.emplace_back();
+			child.m_strKey = strToken;
+
+			if (!ParseValue(child))
+				return false;
+		}
+
+		fprintf(stderr, "Unexpected end of file, missing '}' for %s\n", kv.m_strKey.c_str());
+		return false;
+	}
+
+	int GetLine() const
+	{
+		return 1 + (int)std::count(m_strText.begin(), m_strText.begin() + std::min(m_nPos, m_strText.size()), '\n');
+	}
+
+	bool NextToken(std::string& strToken)
+	{
+		strToken.clear();
+
+		while (m_nPos < m_strText.size())
+		{
+			char c = m_strText[m_nPos];
+
+			if (isspace((unsigned char)c))
+			{
+				m_nPos++;
+			}
+			else if (m_strText.compare(m_nPos, 2, "//") == 0)
+			{
+				while (m_nPos < m_strText.size() && m_strText[m_nPos] != '\n')
+					m_nPos++;
+			}
+			else if (c == '{' || c == '}')
+			{
+				strToken = c;
+				m_nPos++;
+				return true;
+			}
+			else if (c == '"')
+			{
+				size_t nEnd = m_strText.find('"', m_nPos + 1);
+
+				if (nEnd == std::string::npos)
+				{
+					fprintf(stderr, "Unterminated string on line %i\n", GetLine());
+					m_nPos = m_strText.size();
+					return false;
+				}
+
+				strToken = m_strText.substr(m_nPos + 1, nEnd - m_nPos - 1);
+				m_nPos = nEnd + 1;
+				return true;
+			}
+			else
+			{
+				size_t nStart = m_nPos;
+
+				while (m_nPos < m_strText.size() && !isspace((unsigned char)m_strText[m_nPos]) && m_strText[m_nPos] != '{' && m_strText[m_nPos] != '}' && m_strText[m_nPos] != '"')
+					m_nPos++;
+
+				strToken = m_strText.substr(nStart, m_nPos - nStart);
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	const std::string& m_strText;
+	size_t m_nPos;
+};
+
+struct ElfSection_t
+{
+	std::string m_strName;
+	const uint8_t* m_pData; // Where the section's bytes are in our mapping of the file
+	uint64_t m_nAddress;	// Virtual address the game would load it at
+	uint64_t m_nSize;
+};
+
+// A shared library mapped straight from disk, sections are found the same way GetModuleInformation does it in plat_unix.cpp
+class CElfImage
+{
+public:
+	~CElfImage()
+	{
+		if (m_pMap)
+			munmap(m_pMap, m_nMapSize);
+	}
+
+	bool Load(const char* pszPath)
+	{
+		int fd = open(pszPath, O_RDONLY);
+
+		if (fd == -1)
+		{
+			fprintf(stderr, "Could not open %s\n", pszPath);
+			return false;
+		}
+
+		struct stat st;
+
+		if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(Elf64_Ehdr))
+		{
+			close(fd);
+			fprintf(stderr, "Could not read %s\n", pszPath);
+			return false;
+		}
+
+		m_nMapSize = st.st_size;
+		void* pMap = mmap(nullptr, m_nMapSize, PROT_READ, MAP_PRIVATE, fd, 0);
+		close(fd);
+
+		if (pMap == MAP_FAILED)
+		{
+			fprintf(stderr, "Could not map %s\n", pszPath);
+			return false;
+		}
+
+		m_pMap = static_cast<uint8_t*>(pMap);
+
+		Elf64_Ehdr* ehdr = reinterpret_cast<Elf64_Ehdr*>(m_pMap);
+
+		if (memcmp(ehdr->e_ident, ELFMAG, SELFMAG) != 0 || ehdr->e_ident[EI_CLASS] != ELFCLASS64 || ehdr->e_shoff + (uint64_t)ehdr->e_shnum * ehdr->e_shentsize > m_nMapSize)
+		{
+			fprintf(stderr, "%s is not a 64 bit ELF file\n", pszPath);
+			return false;
+		}
+
+		Elf64_Shdr* shdrs = reinterpret_cast<Elf64_Shdr*>(m_pMap + ehdr->e_shoff);
+		const char* strTab = reinterpret_cast<const char*>(m_pMap + shdrs[ehdr->e_shstrndx].sh_offset);
+
+		for (int i = 0; i < ehdr->e_shnum; i++)
+		{
+			Elf64_Shdr* shdr = reinterpret_cast<Elf64_Shdr*>(reinterpret_cast<uint8_t*>(shdrs) + i * ehdr->e_shentsize);
+
+			// .bss and friends have no bytes in the file to scan
+			if (*(strTab + shdr->sh_name) == '\0' || shdr->sh_type == SHT_NOBITS || shdr->sh_offset + shdr->sh_size > m_nMapSize)
+				continue;
+
+			m_vecSections.push_back({strTab + shdr->sh_name, m_pMap + shdr->sh_offset, shdr->sh_addr, shdr->sh_size});
+		}
+
+		return true;
+	}
+
+	const ElfSection_t* GetSection(const std::string& strName) const
+	{
+		for (const auto& section : m_vecSections)
+			if (section.m_strName == strName)
+				return &section;
+
+		return nullptr;
+	}
+
+	// Looks a symbol up in the dynamic symbol table, which is what dlsym would find at runtime
+	bool FindSymbol(const std::string& strName, uint64_t& nAddress) const
+	{
+		const ElfSection_t* pSymbols = GetSection(".dynsym");
+		const ElfSection_t* pStrings = GetSection(".dynstr");
+
+		if (!pSymbols || !pStrings)
+			return false;
+
+		const Elf64_Sym* pSyms = reinterpret_cast<const Elf64_Sym*>(pSymbols->m_pData);
+
+		for (size_t i = 0; i < pSymbols->m_nSize / sizeof(Elf64_Sym); i++)
+		{
+			if (pSyms[i].st_name >= pStrings->m_nSize || pSyms[i].st_shndx == SHN_UNDEF)
+				continue;
+
+			if (strName == reinterpret_cast<const char*>(pStrings->m_pData + pSyms[i].st_name))
+			{
+				nAddress = pSyms[i].st_value;
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+private:
+	uint8_t* m_pMap = nullptr;
+	size_t m_nMapSize = 0;
+	std::vector<ElfSection_t> m_vecSections;
+};
+
+// Same format CGameConfig::HexStringToUint8Array accepts, "\xAB" per byte
+static bool ParseSignature(const std::string& strSignature, std::vector<uint8_t>& vecBytes)
+{
+	if (strSignature.empty() || strSignature.size() % 4 != 0)
+		return false;
+
+	for (size_t i = 0; i < strSignature.size(); i += 4)
+	{
+		unsigned int nByte;
+
+		if (sscanf(strSignature.c_str() + i, "\\x%2X", &nByte) != 1)
+			return false;
+
+		vecBytes.push_back((uint8_t)nByte);
+	}
+
+	return true;
+}
+
+struct SignatureResult_t
+{
+	std::string m_strName;
+	std::string m_strLibrary;
+	std::string m_strSection;
+	std::vector<uint8_t> m_vecBytes;
+	int m_nMatches;
+	uint64_t m_nAddress;
+	double m_flBestTime;
+	double m_flTotalTime;
+};
+
+static double GetMilliseconds(std::chrono::steady_clock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char** argv)
+{
+	std::string strGame = "csgo";
+	int nIterations = 1;
+	const char* pszGamedataPath = nullptr;
+	std::map<std::string, std::string> mapLibraryPaths;
+
+	bool bValidArgs = true;
+
+	for (int i = 1; i < argc; i++)
+	{
+		const char* pszEquals = strchr(argv[i], '=');
+
+		if (!strcmp(argv[i], "--game") && i + 1 < argc)
+			strGame = argv[++i];
+		else if (!strcmp(argv[i], "--iterations") && i + 1 < argc)
+			nIterations = std::max(atoi(argv[++i]), 1);
+		else if (!pszGamedataPath)
+			pszGamedataPath = argv[i];
+		else if (pszEquals)
+			mapLibraryPaths[std::string(argv[i], pszEquals - argv[i])] = pszEquals + 1;
+		else
+			bValidArgs = false;
+	}
+
+	if (!bValidArgs || !pszGamedataPath || mapLibraryPaths.empty())
+	{
+		fprintf(stderr, "Usage: %s [--game csgo] [--iterations N] <cs2fixes.games.txt> <library>=<path> [<library>=<path> ...]\n", argv[0]);
+		return 2;
+	}
+
+	std::ifstream gamedataFile(pszGamedataPath);
+
+	if (!gamedataFile.is_open())
+	{
+		fprintf(stderr, "Could not open %s\n", pszGamedataPath);
+		return 2;
+	}
+
+	std::stringstream gamedataStream;
+	gamedataStream << gamedataFile.rdbuf();
+	std::string strGamedata = gamedataStream.str();
+
+	KeyValue_t root;
+
+	if (!CKeyValuesReader(strGamedata).Parse(root))
+	{
+		fprintf(stderr, "Could not parse %s\n", pszGamedataPath);
+		return 2;
+	}
+
+	const KeyValue_t* pGames = root.FindKey("Games");
+	const KeyValue_t* pGame = pGames ? pGames->FindKey(strGame) : nullptr;
+	const KeyValue_t* pSignatures = pGame ? pGame->FindKey("Signatures") : nullptr;
+
+	if (!pSignatures)
+	{
+		fprintf(stderr, "No signatures for game %s in %s\n", strGame.c_str(), pszGamedataPath);
+		return 2;
+	}
+
+	std::map<std::string, CElfImage> mapImages;
+
+	for (const auto& [strLibrary, strPath] : mapLibraryPaths)
+		if (!mapImages[strLibrary].Load(strPath.c_str()))
+			return 2;
+
+	std::vector<SignatureResult_t> vecResults;
+	int nSkipped = 0, nFailed = 0;
+
+	// Every signature on its own first, exactly like a lone CModule::FindSignature call
+	for (const auto& entry : pSignatures->m_vecChildren)
+	{
+		std::string strLibrary = entry.GetString("library");
+		std::string strSignature = entry.GetString("linux");
+		std::string strSection = entry.GetString("section");
+
+		if (strSection.empty())
+			strSection = ".text";
+
+		auto it = mapImages.find(strLibrary);
+
+		if (it == mapImages.end())
+		{
+			nSkipped++;
+			continue;
+		}
+
+		const CElfImage& image = it->second;
+		SignatureResult_t result{entry.m_strKey, strLibrary, strSection, {}, 0, 0, 0.0, 0.0};
+
+		if (!strSignature.empty() && strSignature[0] == '@')
+		{
+			result.m_strSection = "symbol";
+			result.m_nMatches = image.FindSymbol(strSignature.substr(1), result.m_nAddress) ? 1 : 0;
+			vecResults.push_back(result);
+			continue;
+		}
+
+		std::vector<uint8_t>& vecBytes = result.m_vecBytes;
+		const ElfSection_t* pSection = image.GetSection(strSection);
+
+		if (!ParseSignature(strSignature, vecBytes) || !pSection)
+		{
+			printf("%-60s invalid signature or missing section %s\n", entry.m_strKey.c_str(), strSection.c_str());
+			nFailed++;
+			continue;
+		}
+
+		const uint8_t* pEnd = pSection->m_pData + pSection->m_nSize;
+		result.m_flBestTime = 1e30;
+
+		for (int i = 0; i < nIterations; i++)
+		{
+			auto start = std::chrono::steady_clock::now();
+
+			CSignatureScanner scanner(vecBytes.data(), vecBytes.size(), true);
+			const uint8_t* pFirst = scanner.FindNext(pSection->m_pData, pEnd);
+			int nMatches = 0;
+
+			// Count every match rather than stopping at the second, that's more useful when fixing a signature
+			for (const uint8_t* pMatch = pFirst; pMatch; pMatch = scanner.FindNext(pMatch + 1, pEnd))
+				nMatches++;
+
+			double flTime = GetMilliseconds(start);
+			result.m_flBestTime = std::min(result.m_flBestTime, flTime);
+			result.m_flTotalTime += flTime;
+			result.m_nMatches = nMatches;
+			result.m_nAddress = pFirst ? pSection->m_nAddress + (pFirst - pSection->m_pData) : 0;
+		}
+
+		vecResults.push_back(result);
+	}
+
+	printf("%-60s %-14s %-10s %8s %14s %10s %10s\n", "Signature", "Library", "Section", "Matches", "Address", "Best ms", "Avg ms");
+
+	double flSeparateTotal = 0.0;
+
+	for (const auto& result : vecResults)
+	{
+		const char* pszStatus = result.m_nMatches == 1 ? "" : (result.m_nMatches == 0 ? "  <-- NOT FOUND" : "  <-- MULTIPLE");
+
+		printf("%-60s %-14s %-10s %8i %#14lx %10.3f %10.3f%s\n", result.m_strName.c_str(), result.m_strLibrary.c_str(), result.m_strSection.c_str(),
+			   result.m_nMatches, (unsigned long)result.m_nAddress, result.m_flBestTime, result.m_flTotalTime / nIterations, pszStatus);
+
+		flSeparateTotal += result.m_flBestTime;
+
+		if (result.m_nMatches != 1)
+			nFailed++;
+	}
+
+	// Then the way the plugin actually resolves them at load, one CMultiSignatureScanner pass per library section
+	std::map<std::pair<std::string, std::string>, CMultiSignatureScanner> mapPassScanners;
+	std::map<std::pair<std::string, std::string>, std::vector<const SignatureResult_t*>> mapPassResults;
+
+	for (const auto& result : vecResults)
+	{
+		if (result.m_strSection == "symbol")
+			continue;
+
+		auto key = std::make_pair(result.m_strLibrary, result.m_strSection);
+		mapPassScanners[key].AddPattern(result.m_vecBytes.data(), result.m_vecBytes.size(), true);
+		mapPassResults[key].push_back(&result);
+	}
+
+	double flBatchTotal = 0.0;
+	int nThreads = std::clamp((int)sysconf(_SC_NPROCESSORS_ONLN), 1, 8);
+
+	for (const auto& [key, scanner] : mapPassScanners)
+	{
+		const ElfSection_t* pSection = mapImages[key.first].GetSection(key.second);
+		double flBestTime = 1e30;
+		std::vector<CMultiSignatureScanner::Result_t> vecPassResults;
+
+		for (int i = 0; i < nIterations; i++)
+		{
+			auto start = std::chrono::steady_clock::now();
+			vecPassResults = scanner.Scan(pSection->m_pData, pSection->m_pData + pSection->m_nSize, nThreads);
+			flBestTime = std::min(flBestTime, GetMilliseconds(start));
+		}
+
+		// The single pass has to agree with the separate scans, otherwise the scanner itself is broken
+		const std::vector<const SignatureResult_t*>& vecPassSignatures = mapPassResults[key];
+
+		for (size_t i = 0; i < vecPassResults.size(); i++)
+		{
+			uint64_t nAddress = vecPassResults[i].m_pFirst ? pSection->m_nAddress + (vecPassResults[i].m_pFirst - pSection->m_pData) : 0;
+
+			if (nAddress != vecPassSignatures[i]->m_nAddress || vecPassResults[i].m_nMatches != std::min(vecPassSignatures[i]->m_nMatches, 2))
+			{
+				printf("Single pass disagrees on %s: %#lx vs %#lx\n", vecPassSignatures[i]->m_strName.c_str(), (unsigned long)nAddress, (unsigned long)vecPassSignatures[i]->m_nAddress);
+				nFailed++;
+			}
+		}
+
+		printf("Single pass over %s %s (%.1f MB, %i signatures, %i threads): %.3f ms\n", key.first.c_str(), key.second.c_str(), pSection->m_nSize / (1024.0 * 1024.0),
+			   (int)vecPassSignatures.size(), nThreads, flBestTime);
+
+		flBatchTotal += flBestTime;
+	}
+
+	printf("\n%i signatures checked, %i problems, %i skipped (library not given)\n", (int)vecResults.size(), nFailed, nSkipped);
+	printf("Separate scans: %.3f ms, single pass per section: %.3f ms\n", flSeparateTotal, flBatchTotal);
+
+	return nFailed ? 1 : 0;
+}
@@ -137,5 +137,5 @@ void ButtonWatch(const CEntityIOOutput* pThis, CEntityInstance* pActivator, CEnt
 	CTimer::Create(5.0f, TIMERFLAG_NONE, [iIndex]() {
 		mapRecentEnts.erase(iIndex);
 		return -1.0f;
-	});
+	}, "buttonwatch/cooldown");
 }
\ No newline at end of file
@@ -646,19 +646,18 @@ CON_COMMAND_CHAT(spec, "[name] - Spectate another player or join spectators")
 	// 1 frame delay as observer services will be null on same frame as spectator team switch
 	CHandle<CCSPlayerController> hPlayer = player->GetHandle();
 	CHandle<CCSPlayerController> hTarget = pTarget->GetHandle();
-	CTimer::Create(0.0f, TIMERFLAG_MAP | TIMERFLAG_ROUND, [hPlayer, hTarget]() {
+	RunNextTick(TIMERFLAG_MAP | TIMERFLAG_ROUND, [hPlayer, hTarget]() {
 		CCSPlayerController* pPlayer = hPlayer.Get();
 		CCSPlayerController* pTargetPlayer = hTarget.Get();
 		if (!pPlayer || !pTargetPlayer)
-			return -1.0f;
+			return;
 		CPlayer_ObserverServices* pObserverServices = pPlayer->GetPawn()->m_pObserverServices();
 		if (!pObserverServices)
-			return -1.0f;
+			return;
 		pObserverServices->m_iObserverMode = OBS_MODE_IN_EYE;
 		pObserverServices->m_iObserverLastMode = OBS_MODE_ROAMING;
 		pObserverServices->m_hObserverTarget = pTargetPlayer->GetPawn();
 		ClientPrint(pPlayer, HUD_PRINTTALK, CHAT_PREFIX "Spectating player %s.", pTargetPlayer->GetPlayerName());
-		return -1.0f;
 	});
 }
 
@@ -83,6 +83,9 @@ public:
 	{
 		static int offset = g_GameConfig->GetOffset("CCSPlayerController_ChangeTeam");
 		CALL_VIRTUAL(void, offset, this, iTeam);
+
+		// Don't rely on player_team firing from inside the call, callers check win conditions straight after
+		g_playerManager->SetPlayerTeam(GetPlayerSlot(), m_iTeamNum);
 	}
 
 	void SwitchTeam(int iTeam)
@@ -91,9 +94,14 @@ public:
 			return;
 
 		if (iTeam == CS_TEAM_SPECTATOR)
+		{
 			ChangeTeam(iTeam);
+		}
 		else
+		{
 			addresses::CCSPlayerController_SwitchTeam(this, iTeam);
+			g_playerManager->SetPlayerTeam(GetPlayerSlot(), m_iTeamNum);
+		}
 	}
 
 	void Respawn()
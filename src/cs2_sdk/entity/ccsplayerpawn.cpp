@@ -43,5 +43,5 @@ void CCSPlayerPawn::FixPlayerModelAnimations()
 		pPawn->Teleport(nullptr, nullptr, &originalVelocity);
 
 		return -1.0f;
-	});
+	}, "player/freeze");
 }
\ No newline at end of file
@@ -19,18 +19,334 @@
 
 #include "schema.h"
 
+#include "../addresses.h"
 #include "../common.h"
 #include "entity/cbaseentity.h"
 #include "plat.h"
 #include "schemasystem/schemasystem.h"
 
-#include "tier0/memdbgon.h"
+#include <algorithm>
+#include <fstream>
+#include <unordered_map>
+#include <vector>
 
-using SchemaKeyValueMap_t = std::map<uint32_t, SchemaKey>;
-using SchemaTableMap_t = std::map<uint32_t, SchemaKeyValueMap_t>;
+#include "tier0/memdbgon.h"
 
 static constexpr uint32_t g_ChainKey = hash_32_fnv1a_const("__m_pChainEntity");
 
+// Flat open addressing table of every resolved (class, field) pair, keyed by both hashes packed together
+// A (class, 0) entry marks the class itself as resolved, even if it turned out to not exist
+class CSchemaOffsetTable
+{
+public:
+	const SchemaKey* Find(uint32_t classKey, uint32_t memberKey) const
+	{
+		if (m_vecEntries.empty())
+			return nullptr;
+
+		uint64_t nKey = MakeKey(classKey, memberKey);
+		size_t nMask = m_vecEntries.size() - 1;
+
+		for (size_t i = Hash(nKey) & nMask;; i = (i + 1) & nMask)
+		{
+			const Entry_t& entry = m_vecEntries[i];
+
+			if (entry.m_nKey == nKey)
+				return &entry.m_value;
+
+			if (entry.m_nKey == 0)
+				return nullptr;
+		}
+	}
+
+	bool Contains(uint32_t classKey, uint32_t memberKey) const { return Find(classKey, memberKey) != nullptr; }
+
+	// Like std::map::insert, an existing entry is left untouched and false is returned
+	bool Insert(uint32_t classKey, uint32_t memberKey, SchemaKey value)
+	{
+		// Keep the load factor at or below 50% so probe sequences stay short
+		if ((m_nCount + 1) * 2 > m_vecEntries.size())
+			Grow();
+
+		uint64_t nKey = MakeKey(classKey, memberKey);
+		size_t nMask = m_vecEntries.size() - 1;
+
+		for (size_t i = Hash(nKey) & nMask;; i = (i + 1) & nMask)
+		{
+			Entry_t& entry = m_vecEntries[i];
+
+			if (entry.m_nKey == nKey)
+				return false;
+
+			if (entry.m_nKey == 0)
+			{
+				entry.m_nKey = nKey;
+				entry.m_value = value;
+				m_nCount++;
+				return true;
+			}
+		}
+	}
+
+	size_t Count() const { return m_nCount; }
+
+private:
+	struct Entry_t
+	{
+		uint64_t m_nKey;
+		SchemaKey m_value;
+	};
+
+	static uint64_t MakeKey(uint32_t classKey, uint32_t memberKey) { return ((uint64_t)classKey << 32) | memberKey; }
+
+	// Both halves are already FNV hashes, this just mixes the class bits into the low bits used for the index
+	static size_t Hash(uint64_t nKey)
+	{
+		nKey ^= nKey >> 33;
+		nKey *= 0xff51afd7ed558ccdULL;
+		nKey ^= nKey >> 33;
+		return (size_t)nKey;
+	}
+
+	void Grow()
+	{
+		std::vector<Entry_t> vecOld = std::move(m_vecEntries);
+
+		m_vecEntries.assign(vecOld.empty() ? 1024 : vecOld.size() * 2, Entry_t{0, {0, false}});
+		m_nCount = 0;
+
+		for (const Entry_t& entry : vecOld)
+			if (entry.m_nKey != 0)
+				Insert(entry.m_nKey >> 32, (uint32_t)entry.m_nKey, entry.m_value);
+	}
+
+	std::vector<Entry_t> m_vecEntries;
+	size_t m_nCount = 0;
+};
+
+static CSchemaOffsetTable g_schemaOffsets;
+
+static std::vector<std::pair<const char*, uint32_t>>& GetRegisteredClasses()
+{
+	// Function local so it's constructed before the first registrar runs, whichever translation unit that's in
+	static std::vector<std::pair<const char*, uint32_t>> vecClasses;
+	return vecClasses;
+}
+
+// Offsets only change when the server binary does, so everything resolved is cached per build of it
+// Next load reads it back in one go instead of walking the schema, or reports what moved if the build changed
+#define SCHEMA_CACHE_PATH "addons/cs2fixes/data/schema_cache.bin"
+
+static constexpr uint32_t g_nSchemaCacheMagic = 0x43534353; // "SCSC"
+static constexpr uint32_t g_nSchemaCacheVersion = 1;
+
+struct SchemaCacheField_t
+{
+	uint32_t m_nKey;
+	std::string m_strName;
+	SchemaKey m_key;
+};
+
+struct SchemaCacheClass_t
+{
+	uint32_t m_nKey;
+	std::string m_strName;
+	bool m_bFound;
+	std::vector<SchemaCacheField_t> m_vecFields;
+};
+
+// Set while schema::Init walks the schema so every resolved class and field also ends up in the cache
+static std::vector<SchemaCacheClass_t>* g_pSchemaCacheRecord = nullptr;
+
+class CSchemaCacheReader
+{
+public:
+	CSchemaCacheReader(const std::vector<char>& vecData) :
+		m_vecData(vecData), m_nPos(0), m_bOverflow(false) {}
+
+	template <class T>
+	T Read()
+	{
+		T value{};
+
+		if (m_nPos + sizeof(T) > m_vecData.size())
+		{
+			m_bOverflow = true;
+			return value;
+		}
+
+		memcpy(&value, m_vecData.data() + m_nPos, sizeof(T));
+		m_nPos += sizeof(T);
+		return value;
+	}
+
+	std::string ReadString()
+	{
+		uint16_t nLength = Read<uint16_t>();
+
+		if (m_nPos + nLength > m_vecData.size())
+		{
+			m_bOverflow = true;
+			return "";
+		}
+
+		std::string str(m_vecData.data() + m_nPos, nLength);
+		m_nPos += nLength;
+		return str;
+	}
+
+	bool IsValid() const { return !m_bOverflow; }
+
+private:
+	const std::vector<char>& m_vecData;
+	size_t m_nPos;
+	bool m_bOverflow;
+};
+
+template <class T>
+static void WriteSchemaCacheValue(std::string& buffer, T value)
+{
+	buffer.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+static void WriteSchemaCacheString(std::string& buffer, const std::string& str)
+{
+	WriteSchemaCacheValue<uint16_t>(buffer, (uint16_t)str.size());
+	buffer.append(str);
+}
+
+static bool ReadSchemaCache(std::string& strBuildId, std::vector<SchemaCacheClass_t>& vecClasses)
+{
+	char szPath[MAX_PATH];
+	V_snprintf(szPath, sizeof(szPath), "%s%s%s", Plat_GetGameDirectory(), "/csgo/", SCHEMA_CACHE_PATH);
+	std::ifstream cacheFile(szPath, std::ios::binary | std::ios::ate);
+
+	if (!cacheFile.is_open())
+		return false;
+
+	std::vector<char> vecData((size_t)cacheFile.tellg());
+	cacheFile.seekg(0);
+
+	if (!cacheFile.read(vecData.data(), vecData.size()))
+		return false;
+
+	CSchemaCacheReader reader(vecData);
+
+	if (reader.Read<uint32_t>() != g_nSchemaCacheMagic || reader.Read<uint32_t>() != g_nSchemaCacheVersion)
+		return false;
+
+	strBuildId = reader.ReadString();
+	uint32_t nClasses = reader.Read<uint32_t>();
+
+	for (uint32_t i = 0; i < nClasses && reader.IsValid(); i++)
+	{
+		SchemaCacheClass_t& cacheClass = vecClasses.emplace_back();
+		cacheClass.m_nKey = reader.Read<uint32_t>();
+		cacheClass.m_strName = reader.ReadString();
+		cacheClass.m_bFound = reader.Read<uint8_t>();
+
+		uint32_t nFields = reader.Read<uint32_t>();
+
+		for (uint32_t j = 0; j < nFields && reader.IsValid(); j++)
+		{
+			SchemaCacheField_t& cacheField = cacheClass.m_vecFields.emplace_back();
+			cacheField.m_nKey = reader.Read<uint32_t>();
+			cacheField.m_strName = reader.ReadString();
+			cacheField.m_key.offset = reader.Read<int32_t>();
+			cacheField.m_key.networked = reader.Read<uint8_t>();
+		}
+	}
+
+	if (!reader.IsValid())
+	{
+		Warning("Schema cache %s is truncated, ignoring it\n", SCHEMA_CACHE_PATH);
+		vecClasses.clear();
+		return false;
+	}
+
+	return true;
+}
+
+static void WriteSchemaCache(const std::string& strBuildId, const std::vector<SchemaCacheClass_t>& vecClasses)
+{
+	std::string buffer;
+
+	WriteSchemaCacheValue(buffer, g_nSchemaCacheMagic);
+	WriteSchemaCacheValue(buffer, g_nSchemaCacheVersion);
+	WriteSchemaCacheString(buffer, strBuildId);
+	WriteSchemaCacheValue<uint32_t>(buffer, (uint32_t)vecClasses.size());
+
+	for (const auto& cacheClass : vecClasses)
+	{
+		WriteSchemaCacheValue(buffer, cacheClass.m_nKey);
+		WriteSchemaCacheString(buffer, cacheClass.m_strName);
+		WriteSchemaCacheValue<uint8_t>(buffer, cacheClass.m_bFound);
+		WriteSchemaCacheValue<uint32_t>(buffer, (uint32_t)cacheClass.m_vecFields.size());
+
+		for (const auto& cacheField : cacheClass.m_vecFields)
+		{
+			WriteSchemaCacheValue(buffer, cacheField.m_nKey);
+			WriteSchemaCacheString(buffer, cacheField.m_strName);
+			WriteSchemaCacheValue<int32_t>(buffer, cacheField.m_key.offset);
+			WriteSchemaCacheValue<uint8_t>(buffer, cacheField.m_key.networked);
+		}
+	}
+
+	char szPath[MAX_PATH];
+	V_snprintf(szPath, sizeof(szPath), "%s%s%s", Plat_GetGameDirectory(), "/csgo/", SCHEMA_CACHE_PATH);
+	std::ofstream cacheFile(szPath, std::ios::binary | std::ios::trunc);
+
+	if (!cacheFile.is_open() || !cacheFile.write(buffer.data(), buffer.size()))
+		Warning("Failed to write schema cache to %s\n", SCHEMA_CACHE_PATH);
+}
+
+// Compare what the previous build had cached against what was just resolved, so offset moves after a game update are visible
+static void ReportSchemaChanges(const std::vector<SchemaCacheClass_t>& vecOld, const std::vector<SchemaCacheClass_t>& vecNew)
+{
+	std::unordered_map<uint64_t, std::pair<const SchemaCacheClass_t*, const SchemaCacheField_t*>> mapOld;
+
+	for (const auto& cacheClass : vecOld)
+		for (const auto& cacheField : cacheClass.m_vecFields)
+			mapOld[((uint64_t)cacheClass.m_nKey << 32) | cacheField.m_nKey] = {&cacheClass, &cacheField};
+
+	int nMoved = 0, nAdded = 0;
+
+	for (const auto& cacheClass : vecNew)
+	{
+		for (const auto& cacheField : cacheClass.m_vecFields)
+		{
+			auto it = mapOld.find(((uint64_t)cacheClass.m_nKey << 32) | cacheField.m_nKey);
+
+			if (it == mapOld.end())
+			{
+				nAdded++;
+				continue;
+			}
+
+			const SchemaKey& oldKey = it->second.second->m_key;
+
+			if (oldKey.offset != cacheField.m_key.offset || oldKey.networked != cacheField.m_key.networked)
+			{
+				Message("  %s::%s moved from 0x%X%s to 0x%X%s\n", cacheClass.m_strName.c_str(), cacheField.m_strName.c_str(),
+						oldKey.offset, oldKey.networked ? " (networked)" : "", cacheField.m_key.offset, cacheField.m_key.networked ? " (networked)" : "");
+				nMoved++;
+			}
+
+			mapOld.erase(it);
+		}
+	}
+
+	for (const auto& [key, oldField] : mapOld)
+		Message("  %s::%s was removed\n", oldField.first->m_strName.c_str(), oldField.second->m_strName.c_str());
+
+	Message("Server build changed since the schema cache was written: %i fields moved, %i added, %i removed\n", nMoved, nAdded, (int)mapOld.size());
+}
+
+schema::CSchemaClassRegistrar::CSchemaClassRegistrar(const char* className, uint32_t classKey)
+{
+	GetRegisteredClasses().emplace_back(className, classKey);
+}
+
 static bool IsFieldNetworked(SchemaClassFieldData_t& field)
 {
 	for (int i = 0; i < field.m_nStaticMetadataCount; i++)
@@ -43,9 +359,18 @@ static bool IsFieldNetworked(SchemaClassFieldData_t& field)
 	return false;
 }
 
+static void InsertSchemaField(uint32_t classKey, SchemaClassFieldData_t& field)
+{
+	uint32_t memberKey = hash_32_fnv1a_const(field.m_pszName);
+	SchemaKey key = {field.m_nSingleInheritanceOffset, IsFieldNetworked(field)};
+
+	if (g_schemaOffsets.Insert(classKey, memberKey, key) && g_pSchemaCacheRecord)
+		g_pSchemaCacheRecord->back().m_vecFields.push_back({memberKey, field.m_pszName, key});
+}
+
 // Try to recursively find __m_pChainEntity in base classes
 // (e.g. CCSGameRules -> CTeamplayRules -> CMultiplayRules -> CGameRules, in this case it's in CGameRules)
-static void InitChainOffset(SchemaClassInfoData_t* pClassInfo, SchemaKeyValueMap_t& keyValueMap)
+static void InitChainOffset(SchemaClassInfoData_t* pClassInfo, uint32_t classKey)
 {
 	short fieldsSize = pClassInfo->m_nFieldCount;
 	SchemaClassFieldData_t* pFields = pClassInfo->m_pFields;
@@ -57,21 +382,16 @@ static void InitChainOffset(SchemaClassInfoData_t* pClassInfo, SchemaKeyValueMap
 		if (hash_32_fnv1a_const(field.m_pszName) != g_ChainKey)
 			continue;
 
-		std::pair<uint32_t, SchemaKey> keyValuePair;
-		keyValuePair.first = g_ChainKey;
-		keyValuePair.second.offset = field.m_nSingleInheritanceOffset;
-		keyValuePair.second.networked = IsFieldNetworked(field);
-
-		keyValueMap.insert(keyValuePair);
+		InsertSchemaField(classKey, field);
 		return;
 	}
 
 	// Not the base class yet, keep looking
 	if (pClassInfo->m_nBaseClassCount)
-		return InitChainOffset(pClassInfo->m_pBaseClasses[0].m_pClass, keyValueMap);
+		return InitChainOffset(pClassInfo->m_pBaseClasses[0].m_pClass, classKey);
 }
 
-static void InitSchemaKeyValueMap(SchemaClassInfoData_t* pClassInfo, SchemaKeyValueMap_t& keyValueMap)
+static void InitSchemaKeyValueMap(SchemaClassInfoData_t* pClassInfo, uint32_t classKey)
 {
 	short fieldsSize = pClassInfo->m_nFieldCount;
 	SchemaClassFieldData_t* pFields = pClassInfo->m_pFields;
@@ -84,20 +404,15 @@ static void InitSchemaKeyValueMap(SchemaClassInfoData_t* pClassInfo, SchemaKeyVa
 		Message("%s::%s found at -> 0x%X - %llx\n", pClassInfo->m_pszName, field.m_pszName, field.m_nSingleInheritanceOffset, &field);
 #endif
 
-		std::pair<uint32_t, SchemaKey> keyValuePair;
-		keyValuePair.first = hash_32_fnv1a_const(field.m_pszName);
-		keyValuePair.second.offset = field.m_nSingleInheritanceOffset;
-		keyValuePair.second.networked = IsFieldNetworked(field);
-
-		keyValueMap.insert(keyValuePair);
+		InsertSchemaField(classKey, field);
 	}
 
 	// If this is a child class there might be a parent class with __m_pChainEntity
-	if (!keyValueMap.contains(g_ChainKey) && pClassInfo->m_nBaseClassCount)
-		InitChainOffset(pClassInfo->m_pBaseClasses[0].m_pClass, keyValueMap);
+	if (!g_schemaOffsets.Contains(classKey, g_ChainKey) && pClassInfo->m_nBaseClassCount)
+		InitChainOffset(pClassInfo->m_pBaseClasses[0].m_pClass, classKey);
 }
 
-static bool InitSchemaFieldsForClass(SchemaTableMap_t& tableMap, const char* className, uint32_t classKey)
+static bool InitSchemaFieldsForClass(const char* className, uint32_t classKey)
 {
 	CSchemaSystemTypeScope* pType = g_pSchemaSystem->FindTypeScopeForModule(MODULE_PREFIX "server" MODULE_EXT);
 
@@ -106,22 +421,81 @@ static bool InitSchemaFieldsForClass(SchemaTableMap_t& tableMap, const char* cla
 
 	SchemaClassInfoData_t* pClassInfo = pType->FindDeclaredClass(className).Get();
 
+	// Mark the class as resolved either way so we don't search for it again
+	g_schemaOffsets.Insert(classKey, 0, {0, false});
+
+	if (g_pSchemaCacheRecord)
+		g_pSchemaCacheRecord->push_back({classKey, className, pClassInfo != nullptr, {}});
+
 	if (!pClassInfo)
 	{
-		SchemaKeyValueMap_t map;
-		tableMap.insert(std::make_pair(classKey, map));
-
 		Warning("InitSchemaFieldsForClass(): '%s' was not found!\n", className);
 		return false;
 	}
 
-	SchemaKeyValueMap_t& keyValueMap = tableMap.insert(std::make_pair(classKey, SchemaKeyValueMap_t())).first->second;
-
-	InitSchemaKeyValueMap(pClassInfo, keyValueMap);
+	InitSchemaKeyValueMap(pClassInfo, classKey);
 
 	return true;
 }
 
+void schema::Init()
+{
+	std::string strBuildId = modules::server->GetBuildId();
+	std::string strCachedBuildId;
+	std::vector<SchemaCacheClass_t> vecCached;
+
+	bool bHasCache = ReadSchemaCache(strCachedBuildId, vecCached);
+	bool bSameBuild = bHasCache && !strBuildId.empty() && strCachedBuildId == strBuildId;
+
+	if (bSameBuild)
+	{
+		for (const auto& cacheClass : vecCached)
+		{
+			g_schemaOffsets.Insert(cacheClass.m_nKey, 0, {0, false});
+
+			if (!cacheClass.m_bFound)
+				Warning("InitSchemaFieldsForClass(): '%s' was not found!\n", cacheClass.m_strName.c_str());
+
+			for (const auto& cacheField : cacheClass.m_vecFields)
+				g_schemaOffsets.Insert(cacheClass.m_nKey, cacheField.m_nKey, cacheField.m_key);
+		}
+
+		// Classes declared since the cache was written still have to be resolved, otherwise we're done
+		bool bComplete = std::all_of(GetRegisteredClasses().begin(), GetRegisteredClasses().end(), [](const auto& registered) {
+			return g_schemaOffsets.Contains(registered.second, 0);
+		});
+
+		if (bComplete)
+		{
+			Message("Loaded %i schema fields from cache for server build %s\n", (int)g_schemaOffsets.Count(), strBuildId.c_str());
+			return;
+		}
+	}
+
+	// Anything taken from the cache is written back out along with whatever gets resolved now
+	std::vector<SchemaCacheClass_t> vecResolved;
+
+	if (bSameBuild)
+		vecResolved = std::move(vecCached);
+
+	g_pSchemaCacheRecord = &vecResolved;
+
+	for (const auto& [className, classKey] : GetRegisteredClasses())
+		if (!g_schemaOffsets.Contains(classKey, 0))
+			InitSchemaFieldsForClass(className, classKey);
+
+	g_pSchemaCacheRecord = nullptr;
+
+	Message("Resolved %i schema fields for %i classes\n", (int)g_schemaOffsets.Count(), (int)GetRegisteredClasses().size());
+
+	if (bHasCache && !bSameBuild)
+		ReportSchemaChanges(vecCached, vecResolved);
+
+	// Without a build ID there's no way to tell when the cache goes stale, so don't write one at all
+	if (!strBuildId.empty())
+		WriteSchemaCache(strBuildId, vecResolved);
+}
+
 int16_t schema::FindChainOffset(const char* className, uint32_t classNameHash)
 {
 	return schema::GetOffset(className, classNameHash, "__m_pChainEntity", g_ChainKey).offset;
@@ -129,19 +503,13 @@ int16_t schema::FindChainOffset(const char* className, uint32_t classNameHash)
 
 SchemaKey schema::GetOffset(const char* className, uint32_t classKey, const char* memberName, uint32_t memberKey)
 {
-	static SchemaTableMap_t schemaTableMap;
-
-	if (!schemaTableMap.contains(classKey))
-	{
-		if (InitSchemaFieldsForClass(schemaTableMap, className, classKey))
-			return GetOffset(className, classKey, memberName, memberKey);
-
+	// Classes are normally resolved in schema::Init, this only catches lookups that happen before it
+	if (!g_schemaOffsets.Contains(classKey, 0) && !InitSchemaFieldsForClass(className, classKey))
 		return {0, 0};
-	}
 
-	SchemaKeyValueMap_t tableMap = schemaTableMap[classKey];
+	const SchemaKey* pKey = g_schemaOffsets.Find(classKey, memberKey);
 
-	if (!tableMap.contains(memberKey))
+	if (!pKey)
 	{
 		if (memberKey != g_ChainKey)
 			Warning("schema::GetOffset(): '%s' was not found in '%s'!\n", memberName, className);
@@ -149,7 +517,7 @@ SchemaKey schema::GetOffset(const char* className, uint32_t classKey, const char
 		return {0, 0};
 	}
 
-	return tableMap[memberKey];
+	return *pKey;
 }
 
 void NetworkVarStateChanged(uintptr_t pNetworkVar, uint32_t nOffset, uint32 nNetworkStateChangedOffset)
@@ -66,6 +66,16 @@ namespace schema
 {
 	int16_t FindChainOffset(const char* className, uint32_t classNameHash);
 	SchemaKey GetOffset(const char* className, uint32_t classKey, const char* memberName, uint32_t memberKey);
+
+	// Resolves every class registered through DECLARE_SCHEMA_CLASS up front, so SCHEMA_FIELD lookups never walk the schema
+	void Init();
+
+	// Every DECLARE_SCHEMA_CLASS registers its class name with one of these during static initialization
+	class CSchemaClassRegistrar
+	{
+	public:
+		CSchemaClassRegistrar(const char* className, uint32_t classKey);
+	};
 } // namespace schema
 
 constexpr uint32_t val_32_const = 0x811c9dc5;
@@ -227,6 +237,8 @@ private:
 	static constexpr const char* m_className = #ClassName;                       \
 	static constexpr uint32_t m_classNameHash = hash_32_fnv1a_const(#ClassName); \
 	static constexpr int m_networkStateChangedOffset = offset;                   \
+	static inline schema::CSchemaClassRegistrar m_schemaClassRegistrar{          \
+		m_className, m_classNameHash};                                           \
                                                                                  \
 public:
 
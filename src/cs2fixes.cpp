@@ -45,6 +45,7 @@
 #include "interface.h"
 #include "leader.h"
 #include "map_votes.h"
+#include "netevents.h"
 #include "networkstringtabledefs.h"
 #include "panoramavote.h"
 #include "patches.h"
@@ -52,6 +53,7 @@
 #include "playermanager.h"
 #include "schemasystem/schemasystem.h"
 #include "serversideclient.h"
+#include "soundfilter.h"
 #include "te.pb.h"
 #include "tier0/dbg.h"
 #include "tier0/vprof.h"
@@ -146,6 +148,8 @@ int g_iSetGameSpawnGroupMgrId = -1;
 
 double g_flUniversalTime = 0.0;
 float g_flLastTickedTime = 0.0f;
+uint64 g_nUniversalTick = 0;
+int g_nLastTickedTickcount = 0;
 bool g_bHasTicked = false;
 
 CGameEntitySystem* GameEntitySystem()
@@ -235,6 +239,9 @@ bool CS2Fixes::Load(PluginId id, ISmmAPI* ismm, char* error, size_t maxlen, bool
 	if (!addresses::Initialize(g_GameConfig))
 		bRequiredInitLoaded = false;
 
+	// Resolve all schema offsets now rather than on the first access of each field, this needs the server module for its build ID
+	schema::Init();
+
 	if (!InitPatches(g_GameConfig))
 		bRequiredInitLoaded = false;
 
@@ -384,24 +391,23 @@ bool CS2Fixes::Load(PluginId id, ISmmAPI* ismm, char* error, size_t maxlen, bool
 	g_pEWHandler = new CEWHandler();
 
 	RegisterWeaponCommands();
-
-	// Check hide distance
-	CTimer::Create(0.5f, TIMERFLAG_NONE, []() {
-		g_playerManager->CheckHideDistances();
-		return 0.5f;
-	});
+	LoadStopSoundFilter();
 
 	// Check for the expiration of infractions like mutes or gags
-	CTimer::Create(30.0f, TIMERFLAG_NONE, []() {
-		g_playerManager->CheckInfractions();
-		return 30.0f;
-	});
+	CTimer::CreatePlayerSweep(
+		INFRACTION_CHECK_TICKS, GetTicksUntilPhase(INFRACTION_CHECK_TICKS, INFRACTION_CHECK_PHASE), TIMERFLAG_NONE,
+		[]() { return GetGlobals() != nullptr; },
+		[](int iSlot) { g_playerManager->CheckInfractions(iSlot); },
+		[]() { g_pAdminSystem->SaveInfractions(); }, "admin/infractions");
 
 	// Check for idle players and kick them if permitted by cs2f_idle_kick_* 'convars'
 	CTimer::Create(5.0f, TIMERFLAG_NONE, []() {
 		g_pIdleSystem->CheckForIdleClients();
 		return 5.0f;
-	});
+	}, "idle/check");
+
+	// Log network event stats every cs2f_netevent_stats_interval seconds
+	StartNetEventStatsDump();
 
 	// run our cfg
 	g_pEngineServer2->ServerCommand("exec cs2fixes/cs2fixes");
@@ -700,173 +706,184 @@ void CS2Fixes::Hook_PostEvent(CSplitScreenSlot nSlot, bool bLocalOnly, int nClie
 							  INetworkMessageInternal* pEvent, const CNetMessage* pData, unsigned long nSize, NetChannelBufType_t bufType)
 {
 	// Message( "Hook_PostEvent(%d, %d, %d, %lli)\n", nSlot, bLocalOnly, nClientCount, clients );
+	NetMessageInfo_t* info = pEvent->GetNetMessageInfo();
+
+	PostEventContext_t context{nSlot, bLocalOnly, nClientCount, const_cast<uint64*>(clients), pEvent, pData, nSize, bufType};
+	DispatchPostEvent(info->m_MessageId, context);
+}
+
+POST_EVENT_F(GE_FireBulletsId)
+{
+	if (!g_cvarEnableStopSound.Get())
+		return;
+
 	// Need to explicitly get a pointer to the right function as it's overloaded and SH_CALL can't resolve that
 	static void (IGameEventSystem::*PostEventAbstract)(CSplitScreenSlot, bool, int, const uint64*,
 													   INetworkMessageInternal*, const CNetMessage*, unsigned long, NetChannelBufType_t) = &IGameEventSystem::PostEventAbstract;
 
-	NetMessageInfo_t* info = pEvent->GetNetMessageInfo();
-
-	if (g_cvarEnableStopSound.Get() && info->m_MessageId == GE_FireBulletsId)
+	if (g_playerManager->GetSilenceSoundMask())
 	{
-		if (g_playerManager->GetSilenceSoundMask())
-		{
-			// Post the silenced sound to those who use silencesound
-			// Creating a new event object requires us to include the protobuf c files which I didn't feel like doing yet
-			// So instead just edit the event in place and reset later
-			auto msg = const_cast<CNetMessage*>(pData)->ToPB<CMsgTEFireBullets>();
+		// Post the silenced sound to those who use silencesound
+		// Creating a new event object requires us to include the protobuf c files which I didn't feel like doing yet
+		// So instead just edit the event in place and reset later
+		auto msg = const_cast<CNetMessage*>(context.pData)->ToPB<CMsgTEFireBullets>();
 
-			int32_t weapon_id = msg->weapon_id();
-			int32_t sound_type = msg->sound_type();
-			int32_t item_def_index = msg->item_def_index();
+		int32_t weapon_id = msg->weapon_id();
+		int32_t sound_type = msg->sound_type();
+		int32_t item_def_index = msg->item_def_index();
 
-			// original weapon_id will override new settings if not removed
-			msg->set_weapon_id(0);
-			msg->set_sound_type(9);
-			msg->set_item_def_index(61); // weapon_usp_silencer
+		// original weapon_id will override new settings if not removed
+		msg->set_weapon_id(0);
+		msg->set_sound_type(9);
+		msg->set_item_def_index(61); // weapon_usp_silencer
 
-			uint64 clientMask = *(uint64*)clients & g_playerManager->GetSilenceSoundMask();
+		uint64 clientMask = *context.pClients & g_playerManager->GetSilenceSoundMask();
 
-			SH_CALL(g_gameEventSystem, PostEventAbstract)
-			(nSlot, bLocalOnly, nClientCount, &clientMask, pEvent, msg, nSize, bufType);
+		SH_CALL(g_gameEventSystem, PostEventAbstract)
+		(context.nSlot, context.bLocalOnly, context.nClientCount, &clientMask, context.pEvent, msg, context.nSize, context.bufType);
 
-			msg->set_weapon_id(weapon_id);
-			msg->set_sound_type(sound_type);
-			msg->set_item_def_index(item_def_index);
-		}
-
-		// Filter out people using stop/silence sound from the original event
-		*(uint64*)clients &= ~g_playerManager->GetStopSoundMask();
-		*(uint64*)clients &= ~g_playerManager->GetSilenceSoundMask();
-	}
-	else if (info->m_MessageId == TE_WorldDecalId)
-	{
-		*(uint64*)clients &= ~g_playerManager->GetStopDecalsMask();
-	}
-	else if (info->m_MessageId == GE_Source1LegacyGameEvent)
-	{
-		if (g_cvarEnableLeader.Get())
-			Leader_PostEventAbstract_Source1LegacyGameEvent(clients, pData);
+		msg->set_weapon_id(weapon_id);
+		msg->set_sound_type(sound_type);
+		msg->set_item_def_index(item_def_index);
 	}
-	else if (info->m_MessageId == UM_Shake)
-	{
-		auto pPBData = const_cast<CNetMessage*>(pData)->ToPB<CUserMessageShake>();
-		if (g_cvarMaxShakeAmp.Get() >= 0 && pPBData->amplitude() > g_cvarMaxShakeAmp.Get())
-			pPBData->set_amplitude(g_cvarMaxShakeAmp.Get());
 
-		// remove client with noshake from the event
-		if (g_cvarEnableNoShake.Get())
-			*(uint64*)clients &= ~g_playerManager->GetNoShakeMask();
-	}
-	else if (info->m_MessageId == GE_SosStartSoundEvent)
+	// Filter out people using stop/silence sound from the original event
+	*context.pClients &= ~g_playerManager->GetStopSoundMask();
+	*context.pClients &= ~g_playerManager->GetSilenceSoundMask();
+}
+
+POST_EVENT_F(TE_WorldDecalId)
+{
+	*context.pClients &= ~g_playerManager->GetStopDecalsMask();
+}
+
+POST_EVENT_F(UM_Shake)
+{
+	auto pPBData = const_cast<CNetMessage*>(context.pData)->ToPB<CUserMessageShake>();
+	if (g_cvarMaxShakeAmp.Get() >= 0 && pPBData->amplitude() > g_cvarMaxShakeAmp.Get())
+		pPBData->set_amplitude(g_cvarMaxShakeAmp.Get());
+
+	// remove client with noshake from the event
+	if (g_cvarEnableNoShake.Get())
+		*context.pClients &= ~g_playerManager->GetNoShakeMask();
+}
+
+// Sounds muted by stopsound, more can be added through configs/stopsound.jsonc
+static const char* g_szStopSoundEvents[] =
 	{
-		auto msg = const_cast<CNetMessage*>(pData)->ToPB<CMsgSosStartSoundEvent>();
+		"Weapon_Knife.HitWall",
+		"Weapon_Knife.Slash",
+		"Weapon_Knife.Hit",
+		"Weapon_Knife.Stab",
+		"Weapon_sg556.ZoomIn",
+		"Weapon_sg556.ZoomOut",
+		"Weapon_AUG.ZoomIn",
+		"Weapon_AUG.ZoomOut",
+		"Weapon_SSG08.Zoom",
+		"Weapon_SSG08.ZoomOut",
+		"Weapon_SCAR20.Zoom",
+		"Weapon_SCAR20.ZoomOut",
+		"Weapon_G3SG1.Zoom",
+		"Weapon_G3SG1.ZoomOut",
+		"Weapon_AWP.Zoom",
+		"Weapon_AWP.ZoomOut",
+		"Weapon_Revolver.Prepare",
+		"T_Default.StepLeft",
+		"CT_Default.StepLeft",
+		"Player.DamageBody.AttackerFeedback",
+		"Player.DamageBody.Onlooker",
+		"Player.DamageBody.Victim",
+		"Player.DamageBody.VictimFlesh",
+		"Player.DamageBodyArmor.AttackerFeedback",
+		"Player.DamageBodyArmor.Onlooker",
+		"Player.DamageBodyArmor.Victim",
+		"Player.DamageBodyArmor.OnlookerFlesh",
+		"Player.DamageBodyArmor.AttackerFeedbackFlesh",
+		"Player.DamageHeadShot.Onlooker",
+		"Player.DamageHeadShot.Victim",
+		"Player.DamageHeadShotArmor.AttackerFeedback",
+		"Player.DamageHeadShotArmor.Onlooker",
+		"Player.DamageHeadShotArmor.Victim",
+		"Player.DamageFall",
+		"Player.DamageFall.Fem",
+		"Player.Death",
+		"Player.DeathBody.AttackerFeedback",
+		"Player.DeathBody.Onlooker",
+		"Player.DeathBody.Victim",
+		"Player.DeathBody.Flesh",
+		"Player.DeathBodyArmor.AttackerFeedback",
+		"Player.DeathBodyArmor.Onlooker",
+		"Player.DeathBodyArmor.Victim",
+		"Player.DeathHeadShot.AttackerFeedback",
+		"Player.DeathHeadShot.Onlooker",
+		"Player.DeathHeadShot.Spectator",
+		"Player.DeathHeadShot.Victim.Dink",
+		"Player.DeathHeadShot.Victim.Flesh",
+		"Player.DeathHeadShotArmor.AttackerFeedback",
+		"Player.DeathHeadShotArmor.Onlooker",
+		"Player.DeathHeadShotArmor.Victim",
+		"Player.DeathHeadShotArmor.Spectator",
+		"Player.DeathHeadShot.AttackerFeedback.Flesh",
+		"Player.DeathHeadShot.AttackerFeedback.Dink",
+		"Player.DeathHeadShot.Flesh",
+		"Player.DeathHeadShot.Dink",
+		"Weapon.AutoSemiAutoSwitch",
+};
 
-		if (g_cvarEnableZR.Get())
-			ZR_PostEventAbstract_SosStartSoundEvent(clients, msg);
+static CSoundEventFilter g_stopSoundFilter;
 
-		if (g_cvarEnableStopSound.Get())
-		{
-			static std::set<uint32> soundEventHashes;
-
-			ExecuteOnce(
-				soundEventHashes.insert(GetSoundEventHash("Weapon_Knife.HitWall"));
-				soundEventHashes.insert(GetSoundEventHash("Weapon_Knife.Slash"));
-				soundEventHashes.insert(GetSoundEventHash("Weapon_Knife.Hit"));
-				soundEventHashes.insert(GetSoundEventHash("Weapon_Knife.Stab"));
-				soundEventHashes.insert(GetSoundEventHash("Weapon_sg556.ZoomIn"));
-				soundEventHashes.insert(GetSoundEventHash("Weapon_sg556.ZoomOut"));
-				soundEventHashes.insert(GetSoundEventHash("Weapon_AUG.ZoomIn"));
-				soundEventHashes.insert(GetSoundEventHash("Weapon_AUG.ZoomOut"));
-				soundEventHashes.insert(GetSoundEventHash("Weapon_SSG08.Zoom"));
-				soundEventHashes.insert(GetSoundEventHash("Weapon_SSG08.ZoomOut"));
-				soundEventHashes.insert(GetSoundEventHash("Weapon_SCAR20.Zoom"));
-				soundEventHashes.insert(GetSoundEventHash("Weapon_SCAR20.ZoomOut"));
-				soundEventHashes.insert(GetSoundEventHash("Weapon_G3SG1.Zoom"));
-				soundEventHashes.insert(GetSoundEventHash("Weapon_G3SG1.ZoomOut"));
-				soundEventHashes.insert(GetSoundEventHash("Weapon_AWP.Zoom"));
-				soundEventHashes.insert(GetSoundEventHash("Weapon_AWP.ZoomOut"));
-				soundEventHashes.insert(GetSoundEventHash("Weapon_Revolver.Prepare"));
-				soundEventHashes.insert(GetSoundEventHash("T_Default.StepLeft"));
-				soundEventHashes.insert(GetSoundEventHash("CT_Default.StepLeft"));
-				soundEventHashes.insert(GetSoundEventHash("Player.DamageBody.AttackerFeedback"));
-				soundEventHashes.insert(GetSoundEventHash("Player.DamageBody.Onlooker"));
-				soundEventHashes.insert(GetSoundEventHash("Player.DamageBody.Victim"));
-				soundEventHashes.insert(GetSoundEventHash("Player.DamageBody.VictimFlesh"));
-				soundEventHashes.insert(GetSoundEventHash("Player.DamageBodyArmor.AttackerFeedback"));
-				soundEventHashes.insert(GetSoundEventHash("Player.DamageBodyArmor.Onlooker"));
-				soundEventHashes.insert(GetSoundEventHash("Player.DamageBodyArmor.Victim"));
-				soundEventHashes.insert(GetSoundEventHash("Player.DamageBodyArmor.OnlookerFlesh"));
-				soundEventHashes.insert(GetSoundEventHash("Player.DamageBodyArmor.AttackerFeedbackFlesh"));
-				soundEventHashes.insert(GetSoundEventHash("Player.DamageHeadShot.Onlooker"));
-				soundEventHashes.insert(GetSoundEventHash("Player.DamageHeadShot.Victim"));
-				soundEventHashes.insert(GetSoundEventHash("Player.DamageHeadShotArmor.AttackerFeedback"));
-				soundEventHashes.insert(GetSoundEventHash("Player.DamageHeadShotArmor.Onlooker"));
-				soundEventHashes.insert(GetSoundEventHash("Player.DamageHeadShotArmor.Victim"));
-				soundEventHashes.insert(GetSoundEventHash("Player.DamageFall"));
-				soundEventHashes.insert(GetSoundEventHash("Player.DamageFall.Fem"));
-				soundEventHashes.insert(GetSoundEventHash("Player.Death"));
-				soundEventHashes.insert(GetSoundEventHash("Player.DeathBody.AttackerFeedback"));
-				soundEventHashes.insert(GetSoundEventHash("Player.DeathBody.Onlooker"));
-				soundEventHashes.insert(GetSoundEventHash("Player.DeathBody.Victim"));
-				soundEventHashes.insert(GetSoundEventHash("Player.DeathBody.Flesh"));
-				soundEventHashes.insert(GetSoundEventHash("Player.DeathBodyArmor.AttackerFeedback"));
-				soundEventHashes.insert(GetSoundEventHash("Player.DeathBodyArmor.Onlooker"));
-				soundEventHashes.insert(GetSoundEventHash("Player.DeathBodyArmor.Victim"));
-				soundEventHashes.insert(GetSoundEventHash("Player.DeathHeadShot.AttackerFeedback"));
-				soundEventHashes.insert(GetSoundEventHash("Player.DeathHeadShot.Onlooker"));
-				soundEventHashes.insert(GetSoundEventHash("Player.DeathHeadShot.Spectator"));
-				soundEventHashes.insert(GetSoundEventHash("Player.DeathHeadShot.Victim.Dink"));
-				soundEventHashes.insert(GetSoundEventHash("Player.DeathHeadShot.Victim.Flesh"));
-				soundEventHashes.insert(GetSoundEventHash("Player.DeathHeadShotArmor.AttackerFeedback"));
-				soundEventHashes.insert(GetSoundEventHash("Player.DeathHeadShotArmor.Onlooker"));
-				soundEventHashes.insert(GetSoundEventHash("Player.DeathHeadShotArmor.Victim"));
-				soundEventHashes.insert(GetSoundEventHash("Player.DeathHeadShotArmor.Spectator"));
-				soundEventHashes.insert(GetSoundEventHash("Player.DeathHeadShot.AttackerFeedback.Flesh"));
-				soundEventHashes.insert(GetSoundEventHash("Player.DeathHeadShot.AttackerFeedback.Dink"));
-				soundEventHashes.insert(GetSoundEventHash("Player.DeathHeadShot.Flesh"));
-				soundEventHashes.insert(GetSoundEventHash("Player.DeathHeadShot.Dink"));
-				soundEventHashes.insert(GetSoundEventHash("Weapon.AutoSemiAutoSwitch")););
-
-			if (!soundEventHashes.contains(msg->soundevent_hash()))
-				return;
-
-			uint64 stopSoundMask = g_playerManager->GetStopSoundMask();
-			uint64 silenceSoundMask = g_playerManager->GetSilenceSoundMask();
-
-			if (!msg->has_source_entity_index())
-				return;
-
-			CBaseEntity* pSourceEntity = (CBaseEntity*)g_pEntitySystem->GetEntityInstance(CEntityIndex(msg->source_entity_index()));
-			int playerSlot = -1;
-
-			if (!pSourceEntity)
-				return;
-
-			if (!V_strcasecmp(pSourceEntity->GetClassname(), "player"))
-			{
-				playerSlot = ((CCSPlayerPawn*)pSourceEntity)->GetController()->GetPlayerSlot();
-			}
-			else if (!V_strncasecmp(pSourceEntity->GetClassname(), "weapon_", 7))
-			{
-				CCSPlayerPawn* pPawn = (CCSPlayerPawn*)pSourceEntity->m_hOwnerEntity().Get();
+bool LoadStopSoundFilter()
+{
+	g_stopSoundFilter.Clear();
 
-				if (pPawn && pPawn->IsPawn())
-					playerSlot = pPawn->GetController()->GetPlayerSlot();
-			}
+	for (const char* pszSoundEvent : g_szStopSoundEvents)
+		g_stopSoundFilter.AddSoundEvent(pszSoundEvent);
 
-			// Remove player who triggered this sound from masks
-			// Because some of these sounds never get played locally (Zoom's, Knife Hit/Stab)
-			if (playerSlot != -1 && g_playerManager->IsPlayerUsingStopSound(playerSlot))
-				stopSoundMask &= ~((uint64)1 << playerSlot);
+	bool bSuccess = g_stopSoundFilter.AddFromConfig("addons/cs2fixes/configs/stopsound.jsonc");
+	g_stopSoundFilter.Finalize();
 
-			if (playerSlot != -1 && g_playerManager->IsPlayerUsingSilenceSound(playerSlot))
-				silenceSoundMask &= ~((uint64)1 << playerSlot);
+	return bSuccess;
+}
 
-			// Filter out people using stop/silence sound from hearing this sound from other players
-			*(uint64*)clients &= ~stopSoundMask;
-			*(uint64*)clients &= ~silenceSoundMask;
-		}
-	}
+CON_COMMAND_F(c_reload_stopsound, "- Reload the stopsound sound event config", FCVAR_SPONLY | FCVAR_LINKED_CONCOMMAND)
+{
+	if (LoadStopSoundFilter())
+		Message("Stopsound config reloaded, %i sound events filtered\n", g_stopSoundFilter.Count());
+}
+
+POST_EVENT_F(GE_SosStartSoundEvent)
+{
+	if (!g_cvarEnableStopSound.Get())
+		return;
+
+	auto msg = const_cast<CNetMessage*>(context.pData)->ToPB<CMsgSosStartSoundEvent>();
+
+	if (!g_stopSoundFilter.Contains(msg->soundevent_hash()))
+		return;
+
+	uint64 stopSoundMask = g_playerManager->GetStopSoundMask();
+	uint64 silenceSoundMask = g_playerManager->GetSilenceSoundMask();
+
+	if (!msg->has_source_entity_index())
+		return;
+
+	if (!g_pEntitySystem->GetEntityInstance(CEntityIndex(msg->source_entity_index())))
+		return;
+
+	// Player pawns and the weapons they hold, maintained by the player manager
+	int playerSlot = g_playerManager->GetEntityOwnerSlot(msg->source_entity_index());
+
+	// Remove player who triggered this sound from masks
+	// Because some of these sounds never get played locally (Zoom's, Knife Hit/Stab)
+	if (playerSlot != -1 && g_playerManager->IsPlayerUsingStopSound(playerSlot))
+		stopSoundMask &= ~((uint64)1 << playerSlot);
+
+	if (playerSlot != -1 && g_playerManager->IsPlayerUsingSilenceSound(playerSlot))
+		silenceSoundMask &= ~((uint64)1 << playerSlot);
+
+	// Filter out people using stop/silence sound from hearing this sound from other players
+	*context.pClients &= ~stopSoundMask;
+	*context.pClients &= ~silenceSoundMask;
 }
 
 void CS2Fixes::AllPluginsLoaded()
@@ -965,6 +982,8 @@ void CS2Fixes::Hook_OnClientConnected(CPlayerSlot slot, const char* pszName, uin
 	// Ideally we would use CServerSideClient::IsHLTV().. but it doesn't work :(
 	if (bFakePlayer && V_strcmp(pszName, pszTvName))
 		g_playerManager->OnBotConnected(slot);
+	else if (bFakePlayer)
+		g_playerManager->OnHLTVConnected(slot);
 }
 
 bool CS2Fixes::Hook_ClientConnect(CPlayerSlot slot, const char* pszName, uint64 xuid, const char* pszNetworkID, bool unk1, CBufferString* pRejectReason)
@@ -1031,11 +1050,19 @@ void CS2Fixes::Hook_GameFramePost(bool simulating, bool bFirstTick, bool bLastTi
 		return;
 
 	if (simulating && g_bHasTicked)
+	{
 		g_flUniversalTime += GetGlobals()->curtime - g_flLastTickedTime;
 
+		// Like universal time, this keeps counting across map changes where tickcount starts over
+		if (GetGlobals()->tickcount > g_nLastTickedTickcount)
+			g_nUniversalTick += GetGlobals()->tickcount - g_nLastTickedTickcount;
+	}
+
 	g_flLastTickedTime = GetGlobals()->curtime;
+	g_nLastTickedTickcount = GetGlobals()->tickcount;
 	g_bHasTicked = true;
 
+	RunNextTickQueue();
 	RunTimers();
 	EntityHandler_OnGameFramePost(simulating, GetGlobals()->tickcount);
 }
@@ -1048,6 +1075,67 @@ void CS2Fixes::Hook_CheckTransmit(CCheckTransmitInfo** ppInfoList, int infoCount
 
 	VPROF("CS2Fixes::Hook_CheckTransmit");
 
+	// Everything that depends only on the other player is worked out once here, rather than once per (viewer, player) pair below
+	// Other players' flashlights and entwatch huds are never transmitted, players who can be hidden contribute their pawn and weapons
+	static CBitVec<16384> s_neverTransmit;
+	static CBitVec<16384> s_viewerMask;
+	static std::vector<int> s_vecHideEntities[MAXPLAYERS];
+	static int s_iOwnEntities[MAXPLAYERS][2];
+
+	// Words past this are zero in both masks, so there's no need to touch them
+	int nMaskDWords = 0;
+	auto TrackEntity = [&nMaskDWords](int iIndex) {
+		nMaskDWords = std::max(nMaskDWords, (iIndex >> 5) + 1);
+		return iIndex;
+	};
+
+	s_neverTransmit.ClearAll();
+
+	bool bHideFlashLights = !g_cvarFlashLightTransmitOthers.Get();
+	bool bHideEntwatchHuds = g_cvarEnableEntWatch.Get() && g_pEWHandler->IsConfigLoaded();
+	bool bHide = g_cvarEnableHide.Get();
+	bool bHideWeapons = g_cvarHideWeapons.Get();
+
+	const PlayerSnapshot_t& snapshot = g_playerManager->GetSnapshot();
+
+	for (int i = 0; i < GetGlobals()->maxClients; i++)
+	{
+		s_iOwnEntities[i][0] = s_iOwnEntities[i][1] = -1;
+		s_vecHideEntities[i].clear();
+
+		if (!snapshot.m_pController[i] || (snapshot.m_nHLTVMask & ((uint64)1 << i)))
+			continue;
+
+		ZEPlayer* pZEPlayer = g_playerManager->GetPlayer(i);
+		ZEPlayer* pConnectedZEPlayer = snapshot.IsConnected(i) ? pZEPlayer : nullptr;
+
+		CBarnLight* pFlashLight = pConnectedZEPlayer ? pConnectedZEPlayer->GetFlashLight() : nullptr;
+
+		if (bHideFlashLights && pFlashLight)
+			s_neverTransmit.Set(s_iOwnEntities[i][0] = TrackEntity(pFlashLight->entindex()));
+
+		CPointWorldText* pHud = pConnectedZEPlayer ? pConnectedZEPlayer->GetEntwatchHud() : nullptr;
+
+		if (bHideEntwatchHuds && pHud)
+			s_neverTransmit.Set(s_iOwnEntities[i][1] = TrackEntity(pHud->entindex()));
+
+		if (!bHide)
+			continue;
+
+		// Get the actual pawn as the player could be currently spectating
+		CCSPlayerPawn* pPawn = snapshot.m_pPlayerPawn[i];
+
+		// Do not hide leaders or item holders to other players
+		if (!pPawn || !pZEPlayer || pZEPlayer->IsLeader() || g_pEWHandler->IsItemHolder(i))
+			continue;
+
+		s_vecHideEntities[i].push_back(TrackEntity(pPawn->entindex()));
+
+		if (bHideWeapons)
+			for (int iWeaponIndex : g_playerManager->GetPlayerWeapons(i))
+				s_vecHideEntities[i].push_back(TrackEntity(iWeaponIndex));
+	}
+
 	for (int i = 0; i < infoCount; i++)
 	{
 		auto& pInfo = ppInfoList[i];
@@ -1057,9 +1145,9 @@ void CS2Fixes::Hook_CheckTransmit(CCheckTransmitInfo** ppInfoList, int infoCount
 		static int offset = g_GameConfig->GetOffset("CheckTransmitPlayerSlot");
 		int iPlayerSlot = (int)*((uint8*)pInfo + offset);
 
-		CCSPlayerController* pSelfController = CCSPlayerController::FromSlot(iPlayerSlot);
+		CCSPlayerController* pSelfController = snapshot.m_pController[iPlayerSlot];
 
-		if (!pSelfController || !pSelfController->IsConnected())
+		if (!pSelfController || !snapshot.IsConnected(iPlayerSlot))
 			continue;
 
 		auto pSelfZEPlayer = g_playerManager->GetPlayer(iPlayerSlot);
@@ -1067,57 +1155,31 @@ void CS2Fixes::Hook_CheckTransmit(CCheckTransmitInfo** ppInfoList, int infoCount
 		if (!pSelfZEPlayer)
 			continue;
 
-		for (int j = 0; j < GetGlobals()->maxClients; j++)
-		{
-			CCSPlayerController* pController = CCSPlayerController::FromSlot(j);
-			// Always transmit to themselves
-			if (!pController || pController->m_bIsHLTV || j == iPlayerSlot)
-				continue;
-
-			// Don't transmit other players' flashlights
-			CBarnLight* pFlashLight = pController->IsConnected() ? g_playerManager->GetPlayer(j)->GetFlashLight() : nullptr;
-
-			if (!g_cvarFlashLightTransmitOthers.Get() && pFlashLight)
-				pInfo->m_pTransmitEntity->Clear(pFlashLight->entindex());
+		uint32* pMask = s_viewerMask.Base();
+		V_memcpy(pMask, s_neverTransmit.Base(), nMaskDWords * sizeof(uint32));
 
-			if (g_cvarEnableEntWatch.Get() && g_pEWHandler->IsConfigLoaded())
+		// Always transmit other players if spectating
+		if (bHide && pSelfController->GetPawnState() != STATE_OBSERVER_MODE)
+		{
+			for (int j = 0; j < GetGlobals()->maxClients; j++)
 			{
-				// Don't transmit other players' entwatch hud
-				CPointWorldText* pHud = pController->IsConnected() ? g_playerManager->GetPlayer(j)->GetEntwatchHud() : nullptr;
-				if (pHud)
-					pInfo->m_pTransmitEntity->Clear(pHud->entindex());
-			}
-
-			// Always transmit other players if spectating
-			if (!g_cvarEnableHide.Get() || pSelfController->GetPawnState() == STATE_OBSERVER_MODE)
-				continue;
-
-			// Get the actual pawn as the player could be currently spectating
-			CCSPlayerPawn* pPawn = pController->GetPlayerPawn();
-
-			if (!pPawn)
-				continue;
+				if (j == iPlayerSlot || s_vecHideEntities[j].empty() || !pSelfZEPlayer->ShouldBlockTransmit(j))
+					continue;
 
-			// Do not hide leaders or item holders to other players
-			ZEPlayer* pOtherZEPlayer = g_playerManager->GetPlayer(j);
-			if (pSelfZEPlayer->ShouldBlockTransmit(j) && pOtherZEPlayer && !pOtherZEPlayer->IsLeader() && g_pEWHandler->FindItemInstanceByOwner(j, false, 0) == -1)
-			{
-				pInfo->m_pTransmitEntity->Clear(pPawn->entindex());
+				for (int iIndex : s_vecHideEntities[j])
+					pMask[iIndex >> 5] |= 1u << (iIndex & 31);
+			}
+		}
 
-				if (g_cvarHideWeapons.Get())
-				{
-					auto pVecWeapons = pPawn->m_pWeaponServices->m_hMyWeapons();
+		// Always transmit to themselves
+		for (int iIndex : s_iOwnEntities[iPlayerSlot])
+			if (iIndex != -1)
+				pMask[iIndex >> 5] &= ~(1u << (iIndex & 31));
 
-					FOR_EACH_VEC(*pVecWeapons, i)
-					{
-						auto pWeapon = (*pVecWeapons)[i].Get();
+		uint32* pTransmit = pInfo->m_pTransmitEntity->Base();
 
-						if (pWeapon)
-							pInfo->m_pTransmitEntity->Clear(pWeapon->entindex());
-					}
-				}
-			}
-		}
+		for (int j = 0; j < nMaskDWords; j++)
+			pTransmit[j] &= ~pMask[j];
 
 		// Don't transmit glow model to it's owner
 		CBaseModelEntity* pGlowModel = pSelfZEPlayer->GetGlowModel();
@@ -1286,6 +1348,8 @@ void CS2Fixes::Hook_DropWeaponPost(CBasePlayerWeapon* pWeapon, Vector* pVecTarge
 		EW_DropWeapon(pWeaponService, pWeapon);
 	}
 
+	g_playerManager->OnWeaponDropped(pWeapon);
+
 	RETURN_META(MRES_IGNORED);
 }
 
@@ -52,8 +52,10 @@ extern CSteamGameServerAPIContext g_steamAPI;
 extern CCSGameRules* g_pGameRules;
 extern CSpawnGroupMgrGameSystem* g_pSpawnGroupMgr;
 extern double g_flUniversalTime;
+extern uint64 g_nUniversalTick;
 extern CGlobalVars* GetGlobals();
 extern uint32 GetSoundEventHash(const char* pszSoundEventName);
+extern bool LoadStopSoundFilter();
 extern CUtlVector<CServerSideClient*>* GetClientList();
 extern CServerSideClient* GetClientBySlot(CPlayerSlot slot);
 extern void FullUpdateAllClients();
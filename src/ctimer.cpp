@@ -18,76 +18,545 @@
  */
 
 #include "ctimer.h"
+#include <algorithm>
+#include <deque>
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
 
-std::list<std::shared_ptr<CTimerBase>> g_timers;
+CConVar<int> g_cvarTimeSliceBudget("cs2f_timeslice_budget_us", FCVAR_NONE, "Microseconds per frame that time sliced player sweeps may take before continuing on the next tick, 0 to always finish them in one frame", 200, true, 0, false, 0);
+CConVar<bool> g_cvarTimerProfiling("cs2f_timer_profile", FCVAR_NONE, "Whether to record execution counts and times of timers for cs2f_timer_stats", false);
 
-void RunTimers()
+struct TimerStats_t
+{
+	const char* m_pszName;
+	uint64 m_nExecutions;
+	double m_flTotalTime;
+	double m_flMaxTime;
+};
+
+struct DueTimer_t
+{
+	uint32 m_iIndex;
+	uint32 m_nGeneration;
+};
+
+struct NextTickEntry_t
+{
+	CInlineCallback<void> m_func;
+	uint64 m_nTimerFlags;
+};
+
+// Ring buffer of work queued for the next frame, it only grows (by doubling) when it's full so steady state use doesn't allocate
+class CNextTickQueue
+{
+public:
+	static CInlineCallback<void>* Push(uint64 nTimerFlags)
+	{
+		if (m_nCount == m_nCapacity)
+			Grow();
+
+		NextTickEntry_t& entry = m_pEntries[(m_iHead + m_nCount) & (m_nCapacity - 1)];
+		m_nCount++;
+
+		entry.m_nTimerFlags = nTimerFlags;
+		return &entry.m_func;
+	}
+
+	static void Run()
+	{
+		CInlineCallback<void> func;
+
+		// Only run what was queued before we started, anything the callbacks queue waits for the next frame
+		for (size_t nRemaining = m_nCount; nRemaining > 0 && m_nCount > 0; nRemaining--)
+		{
+			// Move the callback out first, it's free to queue more work which could reallocate the buffer
+			func.MoveFrom(m_pEntries[m_iHead].m_func);
+			m_iHead = (m_iHead + 1) & (m_nCapacity - 1);
+			m_nCount--;
+
+			// Entries dropped by RemoveTimers() are left empty
+			if (func)
+				func();
+
+			func.Reset();
+		}
+	}
+
+	static void RemoveIf(uint64 iTimerFlag)
+	{
+		for (size_t i = 0; i < m_nCount; i++)
+		{
+			NextTickEntry_t& entry = m_pEntries[(m_iHead + i) & (m_nCapacity - 1)];
+
+			if (!iTimerFlag || (entry.m_nTimerFlags & iTimerFlag))
+				entry.m_func.Reset();
+		}
+	}
+
+	static size_t GetCount() { return m_nCount; }
+
+private:
+	static void Grow()
+	{
+		size_t nNewCapacity = m_nCapacity ? m_nCapacity * 2 : 64;
+		auto pNewEntries = std::make_unique<NextTickEntry_t[]>(nNewCapacity);
+
+		for (size_t i = 0; i < m_nCount; i++)
+		{
+			NextTickEntry_t& entry = m_pEntries[(m_iHead + i) & (m_nCapacity - 1)];
+			pNewEntries[i].m_func.MoveFrom(entry.m_func);
+			pNewEntries[i].m_nTimerFlags = entry.m_nTimerFlags;
+		}
+
+		m_pEntries = std::move(pNewEntries);
+		m_nCapacity = nNewCapacity;
+		m_iHead = 0;
+	}
+
+	static inline std::unique_ptr<NextTickEntry_t[]> m_pEntries;
+	static inline size_t m_nCapacity = 0;
+	static inline size_t m_iHead = 0;
+	static inline size_t m_nCount = 0;
+};
+
+// Min-heap of timer deadlines, either in universal time or in universal ticks
+// Ordered by deadline, ties broken by scheduling order so timers due on the same frame keep running in creation order
+template <class T>
+class CTimerHeap
+{
+public:
+	struct Entry_t
+	{
+		T m_deadline;
+		uint64 m_nSequence;
+		uint32 m_iIndex;
+	};
+
+	void Push(T deadline, uint64 nSequence, uint32 iIndex)
+	{
+		m_vecEntries.push_back({deadline, nSequence, iIndex});
+		std::push_heap(m_vecEntries.begin(), m_vecEntries.end(), Compare);
+	}
+
+	bool HasDue(T now) { return !m_vecEntries.empty() && m_vecEntries.front().m_deadline <= now; }
+
+	Entry_t Pop()
+	{
+		std::pop_heap(m_vecEntries.begin(), m_vecEntries.end(), Compare);
+		Entry_t entry = m_vecEntries.back();
+		m_vecEntries.pop_back();
+		return entry;
+	}
+
+	void MarkStale() { m_nStaleEntries++; }
+
+	void DiscardStale()
+	{
+		if (m_nStaleEntries > 0)
+			m_nStaleEntries--;
+	}
+
+	template <class Pred>
+	void CompactIfNeeded(Pred isStale)
+	{
+		if (m_nStaleEntries < 64 || m_nStaleEntries < m_vecEntries.size() / 2)
+			return;
+
+		std::erase_if(m_vecEntries, isStale);
+		std::make_heap(m_vecEntries.begin(), m_vecEntries.end(), Compare);
+		m_nStaleEntries = 0;
+	}
+
+	size_t Size() { return m_vecEntries.size(); }
+
+private:
+	static bool Compare(const Entry_t& a, const Entry_t& b)
+	{
+		if (a.m_deadline != b.m_deadline)
+			return a.m_deadline > b.m_deadline;
+
+		return a.m_nSequence > b.m_nSequence;
+	}
+
+	std::vector<Entry_t> m_vecEntries;
+	size_t m_nStaleEntries = 0;
+};
+
+// Timers are pooled in a deque so their addresses never change, stopped ones are recycled through a free list and
+// bump their generation to invalidate outstanding handles. Once the pool and the vectors below have grown to the
+// server's high water mark, creating and running timers doesn't allocate anymore.
+// Deadlines are kept in min-heaps (one for time based timers, one for tick based ones) that are never searched: entries
+// belonging to stopped or rescheduled timers are left in place and discarded once they reach the top, or all at once
+// when they start to outnumber the live ones.
+class CTimerScheduler
 {
-	auto iterator = g_timers.begin();
+public:
+	static CTimer* Allocate()
+	{
+		if (!m_vecFreeTimers.empty())
+		{
+			CTimer* pTimer = &m_timerPool[m_vecFreeTimers.back()];
+			m_vecFreeTimers.pop_back();
+			return pTimer;
+		}
 
-	while (iterator != g_timers.end())
+		CTimer* pTimer = &m_timerPool.emplace_back();
+		pTimer->m_iIndex = m_timerPool.size() - 1;
+		pTimer->m_nGeneration = 1;
+		return pTimer;
+	}
+
+	static CTimer* Get(uint32 iIndex, uint32 nGeneration)
+	{
+		if (iIndex >= m_timerPool.size())
+			return nullptr;
+
+		CTimer* pTimer = &m_timerPool[iIndex];
+
+		if (!pTimer->m_bActive || pTimer->m_nGeneration != nGeneration)
+			return nullptr;
+
+		return pTimer;
+	}
+
+	static void Start(CTimer* pTimer)
+	{
+		pTimer->m_bActive = true;
+		Schedule(pTimer);
+	}
+
+	static void Schedule(CTimer* pTimer)
 	{
-		auto pTimer = *iterator;
-		pTimer->Initialize();
+		// Any entry this timer still has in the heap is now stale
+		if (pTimer->m_nScheduleSequence)
+			MarkStale(pTimer);
+
+		pTimer->m_nScheduleSequence = ++m_nSequence;
 
-		// Timer execute
-		if (pTimer->GetLastExecute() + pTimer->GetInterval() <= g_flUniversalTime && !pTimer->Execute(true))
-			iterator = g_timers.erase(iterator);
+		if (pTimer->m_bTickBased)
+			m_tickHeap.Push(pTimer->GetNextExecuteTick(), pTimer->m_nScheduleSequence, pTimer->m_iIndex);
 		else
-			iterator++;
+			m_timeHeap.Push(pTimer->GetNextExecute(), pTimer->m_nScheduleSequence, pTimer->m_iIndex);
 	}
+
+	static void Stop(CTimer* pTimer)
+	{
+		if (!pTimer->m_bActive)
+			return;
+
+		if (pTimer->m_nScheduleSequence)
+			MarkStale(pTimer);
+
+		pTimer->m_bActive = false;
+		pTimer->m_nScheduleSequence = 0;
+
+		// Invalidates every handle to this timer, skipping 0 which default handles use
+		if (++pTimer->m_nGeneration == 0)
+			pTimer->m_nGeneration = 1;
+
+		// A timer cancelled from inside its own callback is released once the callback returns
+		if (!pTimer->m_bExecuting)
+			Release(pTimer);
+
+		CompactIfNeeded();
+	}
+
+	static void RemoveIf(uint64 iTimerFlag)
+	{
+		for (CTimer& timer : m_timerPool)
+			if (timer.m_bActive && timer.IsTimerFlagSet(iTimerFlag))
+				Stop(&timer);
+	}
+
+	static void Run()
+	{
+		// Collect everything that is due before running any of it, this way timers created or rescheduled by the callbacks
+		// (including repeating ones with a 0 interval) are only picked up on the next frame
+		CollectDue(m_timeHeap, (float)g_flUniversalTime);
+		CollectDue(m_tickHeap, g_nUniversalTick);
+
+		for (const DueTimer_t& due : m_vecDueTimers)
+		{
+			// Might have been cancelled, and its slot even reused, by a timer that ran before it this frame
+			CTimer* pTimer = Get(due.m_iIndex, due.m_nGeneration);
+
+			if (!pTimer)
+				continue;
+
+			pTimer->m_bExecuting = true;
+			bool bContinue = g_cvarTimerProfiling.Get() ? ExecuteProfiled(pTimer) : pTimer->Execute();
+			pTimer->m_bExecuting = false;
+
+			if (!pTimer->m_bActive)
+				Release(pTimer);
+			else if (bContinue)
+				Schedule(pTimer);
+			else
+				Stop(pTimer);
+		}
+
+		m_vecDueTimers.clear();
+	}
+
+	static void PrintStats(int iCount)
+	{
+		std::vector<TimerStats_t*> vecStats;
+
+		for (auto& [name, stats] : m_mapStats)
+			if (stats.m_nExecutions > 0)
+				vecStats.push_back(&stats);
+
+		std::sort(vecStats.begin(), vecStats.end(), [](TimerStats_t* a, TimerStats_t* b) { return a->m_flTotalTime > b->m_flTotalTime; });
+
+		if (!g_cvarTimerProfiling.Get())
+			Message("Timer profiling is disabled, enable cs2f_timer_profile to record execution times\n");
+
+		Message("%-32s %10s %12s %10s %10s\n", "Timer", "Runs", "Total (ms)", "Avg (us)", "Max (us)");
+
+		for (int i = 0; i < iCount && i < (int)vecStats.size(); i++)
+		{
+			TimerStats_t* pStats = vecStats[i];
+
+			Message("%-32s %10llu %12.3f %10.2f %10.2f\n", pStats->m_pszName, pStats->m_nExecutions, pStats->m_flTotalTime * 1000.0,
+					pStats->m_flTotalTime * 1000000.0 / pStats->m_nExecutions, pStats->m_flMaxTime * 1000000.0);
+		}
+
+		std::map<std::string_view, int> mapCategories;
+		int iActiveTimers = 0;
+
+		for (CTimer& timer : m_timerPool)
+		{
+			if (!timer.m_bActive)
+				continue;
+
+			std::string_view name(timer.m_pszName);
+			mapCategories[name.substr(0, name.find('/'))]++;
+			iActiveTimers++;
+		}
+
+		Message("\n%d active timers (pool size %d, %d heap entries), %d callbacks queued for next tick\n", iActiveTimers, (int)m_timerPool.size(),
+				(int)(m_timeHeap.Size() + m_tickHeap.Size()), (int)CNextTickQueue::GetCount());
+
+		for (auto& [category, count] : mapCategories)
+			Message("  %-30.*s %d\n", (int)category.size(), category.data(), count);
+	}
+
+	static void ResetStats()
+	{
+		// Timers keep pointers to their stats, so only zero them out
+		for (auto& [name, stats] : m_mapStats)
+		{
+			stats.m_nExecutions = 0;
+			stats.m_flTotalTime = 0.0;
+			stats.m_flMaxTime = 0.0;
+		}
+	}
+
+private:
+	template <class T>
+	static void CollectDue(CTimerHeap<T>& heap, T now)
+	{
+		while (heap.HasDue(now))
+		{
+			auto entry = heap.Pop();
+			CTimer* pTimer = &m_timerPool[entry.m_iIndex];
+
+			if (pTimer->m_nScheduleSequence != entry.m_nSequence)
+			{
+				heap.DiscardStale();
+				continue;
+			}
+
+			pTimer->m_nScheduleSequence = 0;
+			m_vecDueTimers.push_back({entry.m_iIndex, pTimer->m_nGeneration});
+		}
+	}
+
+	static void MarkStale(CTimer* pTimer)
+	{
+		if (pTimer->m_bTickBased)
+			m_tickHeap.MarkStale();
+		else
+			m_timeHeap.MarkStale();
+	}
+
+	static bool ExecuteProfiled(CTimer* pTimer)
+	{
+		if (!pTimer->m_pStats)
+		{
+			auto it = m_mapStats.try_emplace(pTimer->m_pszName, TimerStats_t{pTimer->m_pszName, 0, 0.0, 0.0}).first;
+			pTimer->m_pStats = &it->second;
+		}
+
+		double flStart = Plat_FloatTime();
+		bool bContinue = pTimer->Execute();
+		double flTime = Plat_FloatTime() - flStart;
+
+		TimerStats_t* pStats = pTimer->m_pStats;
+		pStats->m_nExecutions++;
+		pStats->m_flTotalTime += flTime;
+
+		if (flTime > pStats->m_flMaxTime)
+			pStats->m_flMaxTime = flTime;
+
+		return bContinue;
+	}
+
+	static void Release(CTimer* pTimer)
+	{
+		pTimer->m_func.Reset();
+		pTimer->m_tickFunc.Reset();
+		m_vecFreeTimers.push_back(pTimer->m_iIndex);
+	}
+
+	static void CompactIfNeeded()
+	{
+		auto isStale = [](const auto& entry) { return m_timerPool[entry.m_iIndex].m_nScheduleSequence != entry.m_nSequence; };
+
+		m_timeHeap.CompactIfNeeded(isStale);
+		m_tickHeap.CompactIfNeeded(isStale);
+	}
+
+	static inline std::deque<CTimer> m_timerPool;
+	static inline std::vector<uint32> m_vecFreeTimers;
+	static inline CTimerHeap<float> m_timeHeap;
+	static inline CTimerHeap<uint64> m_tickHeap;
+	static inline std::vector<DueTimer_t> m_vecDueTimers;
+	static inline std::unordered_map<std::string_view, TimerStats_t> m_mapStats;
+	static inline uint64 m_nSequence = 0;
+};
+
+CInlineCallback<void>* AllocateNextTick(uint64 nTimerFlags)
+{
+	return CNextTickQueue::Push(nTimerFlags);
+}
+
+void RunNextTickQueue()
+{
+	CNextTickQueue::Run();
+}
+
+void RunTimers()
+{
+	CTimerScheduler::Run();
 }
 
 void RemoveAllTimers()
 {
-	g_timers.clear();
+	CTimerScheduler::RemoveIf(TIMERFLAG_NONE);
+	CNextTickQueue::RemoveIf(TIMERFLAG_NONE);
 }
 
 void RemoveTimers(uint64 iTimerFlag)
 {
-	auto iterator = g_timers.begin();
+	CTimerScheduler::RemoveIf(iTimerFlag);
+	CNextTickQueue::RemoveIf(iTimerFlag);
+}
 
-	while (iterator != g_timers.end())
-		if ((*iterator)->IsTimerFlagSet(iTimerFlag))
-			iterator = g_timers.erase(iterator);
-		else
-			iterator++;
+CON_COMMAND_F(cs2f_timer_stats, "<count|reset> - List the most expensive timers and active timers per category", FCVAR_SPONLY | FCVAR_LINKED_CONCOMMAND)
+{
+	if (args.ArgC() > 1 && !V_stricmp(args[1], "reset"))
+	{
+		CTimerScheduler::ResetStats();
+		Message("Timer stats reset\n");
+		return;
+	}
+
+	CTimerScheduler::PrintStats(args.ArgC() > 1 ? V_StringToInt32(args[1], 20) : 20);
 }
 
-std::weak_ptr<CTimer> CTimer::Create(float flInitialInterval, uint64 nTimerFlags, std::function<float()> func)
+static uint64 g_nTimeSliceTick = 0;
+static double g_flTimeSliceUsed = 0.0;
+
+CTimeSliceBudget::CTimeSliceBudget()
 {
-	auto pTimer = std::make_shared<CTimer>(flInitialInterval, nTimerFlags, func, _timer_constructor_tag{});
+	if (g_nTimeSliceTick != g_nUniversalTick)
+	{
+		g_nTimeSliceTick = g_nUniversalTick;
+		g_flTimeSliceUsed = 0.0;
+	}
 
-	g_timers.push_back(pTimer);
-	return pTimer;
+	m_flStart = Plat_FloatTime();
+}
+
+CTimeSliceBudget::~CTimeSliceBudget()
+{
+	g_flTimeSliceUsed += Plat_FloatTime() - m_flStart;
 }
 
-bool CTimer::Execute(bool bAutomaticExecute)
+bool CTimeSliceBudget::IsExhausted()
 {
-	SetInterval(m_func());
-	SetLastExecute(g_flUniversalTime);
+	if (g_cvarTimeSliceBudget.Get() <= 0)
+		return false;
 
-	bool bContinue = GetInterval() >= 0;
+	return (g_flTimeSliceUsed + Plat_FloatTime() - m_flStart) * 1000000.0 >= g_cvarTimeSliceBudget.Get();
+}
+
+int GetPlayerSweepSlotCount()
+{
+	return GetGlobals() ? GetGlobals()->maxClients : 0;
+}
 
-	// Only scan the timer list if this isn't an automatic execute (RunTimers() already has the iterator to erase)
-	if (!bAutomaticExecute && !bContinue)
-		Cancel();
+int GetTicksUntilPhase(int nPeriod, int nPhase)
+{
+	int nTicks = (nPhase - (int)(g_nUniversalTick % nPeriod)) % nPeriod;
 
-	return bContinue;
+	return nTicks <= 0 ? nTicks + nPeriod : nTicks;
 }
 
-void CTimer::Cancel()
+CTimer* CTimer::Allocate(uint64 nTimerFlags, const char* pszName, bool bTickBased)
 {
-	auto iterator = g_timers.begin();
+	CTimer* pTimer = CTimerScheduler::Allocate();
 
-	while (iterator != g_timers.end())
+	pTimer->m_bTickBased = bTickBased;
+	pTimer->m_flLastExecute = g_flUniversalTime;
+	pTimer->m_nLastExecuteTick = g_nUniversalTick;
+	pTimer->m_nTimerFlags = nTimerFlags;
+	pTimer->m_pszName = pszName ? pszName : "unnamed";
+	pTimer->m_pStats = nullptr;
+
+	return pTimer;
+}
+
+CTimerHandle CTimer::Start(CTimer* pTimer)
+{
+	CTimerScheduler::Start(pTimer);
+
+	return CTimerHandle(pTimer->m_iIndex, pTimer->m_nGeneration);
+}
+
+bool CTimer::Execute()
+{
+	if (m_bTickBased)
 	{
-		if (*iterator == shared_from_this())
-		{
-			g_timers.erase(iterator);
-			break;
-		}
+		m_nTickInterval = m_tickFunc();
+		m_nLastExecuteTick = g_nUniversalTick;
 
-		iterator++;
+		return m_nTickInterval >= 0;
 	}
-}
\ No newline at end of file
+
+	m_flInterval = m_func();
+	m_flLastExecute = g_flUniversalTime;
+
+	return m_flInterval >= 0;
+}
+
+void CTimer::Cancel()
+{
+	CTimerScheduler::Stop(this);
+}
+
+bool CTimerHandle::IsValid() const
+{
+	return CTimerScheduler::Get(m_iIndex, m_nGeneration) != nullptr;
+}
+
+void CTimerHandle::Cancel() const
+{
+	if (CTimer* pTimer = CTimerScheduler::Get(m_iIndex, m_nGeneration))
+		pTimer->Cancel();
+}
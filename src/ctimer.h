@@ -19,9 +19,11 @@
 
 #pragma once
 #include "cs2fixes.h"
-#include <functional>
-#include <list>
-#include <memory>
+#include <algorithm>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
 
 // clang-format off
 #define TIMERFLAG_NONE		(0)
@@ -29,59 +31,251 @@
 #define TIMERFLAG_ROUND		(1 << 1) // Only valid for this round, cancels on new round
 // clang-format on
 
-class CTimerBase
+// A callable stored inline, so timers and next tick work never heap allocate for their captures
+template <class R>
+class CInlineCallback
 {
-protected:
-	CTimerBase(float flInitialInterval, uint64 nTimerFlags) :
-		m_flInterval(flInitialInterval), m_nTimerFlags(nTimerFlags)
-	{}
+public:
+	static constexpr size_t MAX_SIZE = 64;
 
-	void SetInterval(float flInterval) { m_flInterval = flInterval; }
-	void SetLastExecute(float flLastExecute) { m_flLastExecute = flLastExecute; }
+	CInlineCallback() = default;
+	CInlineCallback(const CInlineCallback&) = delete;
+	CInlineCallback& operator=(const CInlineCallback&) = delete;
+	~CInlineCallback() { Reset(); }
 
-public:
-	virtual bool Execute(bool bAutomaticExecute = false) = 0;
-	virtual void Cancel() = 0;
+	template <class F>
+	void Emplace(F&& func)
+	{
+		using Func_t = std::decay_t<F>;
+		static_assert(sizeof(Func_t) <= MAX_SIZE, "Callback captures too much, capture handles or pointers instead");
+		static_assert(alignof(Func_t) <= alignof(std::max_align_t), "Callback is over-aligned");
 
-	float GetInterval() { return m_flInterval; }
-	float GetLastExecute() { return m_flLastExecute; }
-	bool IsTimerFlagSet(uint64 iTimerFlag) { return !iTimerFlag || (m_nTimerFlags & iTimerFlag); }
-	void Initialize()
+		Reset();
+		new (m_storage) Func_t(std::forward<F>(func));
+
+		m_pfnInvoke = [](void* pStorage) -> R {
+			if constexpr (std::is_void_v<R>)
+				(*static_cast<Func_t*>(pStorage))();
+			else
+				return (*static_cast<Func_t*>(pStorage))();
+		};
+
+		m_pfnRelocate = [](void* pDest, void* pSource) {
+			new (pDest) Func_t(std::move(*static_cast<Func_t*>(pSource)));
+			static_cast<Func_t*>(pSource)->~Func_t();
+		};
+
+		m_pfnDestroy = [](void* pStorage) { static_cast<Func_t*>(pStorage)->~Func_t(); };
+	}
+
+	// Takes over the callable of another callback, leaving it empty
+	void MoveFrom(CInlineCallback& other)
 	{
-		if (m_flLastExecute == -1)
-			m_flLastExecute = g_flUniversalTime;
+		Reset();
+
+		if (!other.m_pfnInvoke)
+			return;
+
+		other.m_pfnRelocate(m_storage, other.m_storage);
+		m_pfnInvoke = other.m_pfnInvoke;
+		m_pfnRelocate = other.m_pfnRelocate;
+		m_pfnDestroy = other.m_pfnDestroy;
+
+		other.m_pfnInvoke = nullptr;
+		other.m_pfnRelocate = nullptr;
+		other.m_pfnDestroy = nullptr;
+	}
+
+	void Reset()
+	{
+		if (!m_pfnDestroy)
+			return;
+
+		// Clear first, the destructor of a capture could end up back here
+		auto pfnDestroy = m_pfnDestroy;
+		m_pfnInvoke = nullptr;
+		m_pfnRelocate = nullptr;
+		m_pfnDestroy = nullptr;
+		pfnDestroy(m_storage);
 	}
 
+	explicit operator bool() const { return m_pfnInvoke != nullptr; }
+	R operator()() { return m_pfnInvoke(m_storage); }
+
 private:
-	float m_flInterval;
-	float m_flLastExecute = -1;
-	uint64 m_nTimerFlags;
+	alignas(std::max_align_t) unsigned char m_storage[MAX_SIZE];
+	R (*m_pfnInvoke)(void*) = nullptr;
+	void (*m_pfnRelocate)(void*, void*) = nullptr;
+	void (*m_pfnDestroy)(void*) = nullptr;
+};
+
+using CTimerCallback = CInlineCallback<float>;
+using CTickTimerCallback = CInlineCallback<int>;
+
+// Generation checked reference to a pooled timer, goes invalid as soon as the timer stops or is cancelled
+class CTimerHandle
+{
+	friend class CTimer;
+
+public:
+	CTimerHandle() = default;
+
+	bool IsValid() const;
+	void Cancel() const;
+
+private:
+	CTimerHandle(uint32 iIndex, uint32 nGeneration) :
+		m_iIndex(iIndex), m_nGeneration(nGeneration)
+	{}
+
+	uint32 m_iIndex = 0;
+	uint32 m_nGeneration = 0; // Timer generations start at 1, so a default handle is never valid
+};
+
+struct TimerStats_t;
+
+// Measures time sliced work against cs2f_timeslice_budget_us, which is shared by everything time sliced on the same tick
+class CTimeSliceBudget
+{
+public:
+	CTimeSliceBudget();
+	~CTimeSliceBudget();
+
+	bool IsExhausted();
+
+private:
+	double m_flStart;
 };
 
+int GetPlayerSweepSlotCount();
+
 // Timer functions should return the time until next execution, or a negative value like -1.0f to stop
 // Having an interval of 0 is fine, in this case it will run on every game frame
-class CTimer : public CTimerBase, public std::enable_shared_from_this<CTimer>
+// Timers live in a pool that is recycled, so keep the handle returned by Create() rather than the timer itself
+// The optional name shows up in cs2f_timer_stats, use "category/name" (e.g. "zr/regen") to group timers by category
+// Tick based timers made with CreateTicks() work the same way in whole server ticks, their functions return the number of
+// ticks until next execution instead and they fire on exactly that tick, regardless of how long the server has been up
+class CTimer
 {
-private:
-	// Silly workaround to achieve a "private constructor" only Create() can call
-	struct _timer_constructor_tag
-	{
-		explicit _timer_constructor_tag() = default;
-	};
+	friend class CTimerScheduler;
+	friend class CTimerHandle;
 
 public:
-	CTimer(float flInitialInterval, uint64 nTimerFlags, std::function<float()> func, _timer_constructor_tag) :
-		CTimerBase(flInitialInterval, nTimerFlags), m_func(func)
-	{}
+	template <class F>
+	static CTimerHandle Create(float flInitialInterval, uint64 nTimerFlags, F&& func, const char* pszName = nullptr)
+	{
+		CTimer* pTimer = Allocate(nTimerFlags, pszName, false);
+		pTimer->m_flInterval = flInitialInterval;
+		pTimer->m_func.Emplace(std::forward<F>(func));
+
+		return Start(pTimer);
+	}
+
+	template <class F>
+	static CTimerHandle CreateTicks(int nInitialTicks, uint64 nTimerFlags, F&& func, const char* pszName = nullptr)
+	{
+		CTimer* pTimer = Allocate(nTimerFlags, pszName, true);
+		pTimer->m_nTickInterval = nInitialTicks;
+		pTimer->m_tickFunc.Emplace(std::forward<F>(func));
+
+		return Start(pTimer);
+	}
+
+	// Tick based timer that runs slotFunc(iSlot) for every player slot once every nPeriodTicks, but rather than doing the whole
+	// sweep on one frame it continues on the next tick whenever the frame's time slice budget runs out
+	// beginFunc runs before the first slot and can return false to skip this sweep, endFunc runs after the last slot
+	template <class FBegin, class FSlot, class FEnd>
+	static CTimerHandle CreatePlayerSweep(int nPeriodTicks, int nInitialTicks, uint64 nTimerFlags, FBegin&& beginFunc, FSlot&& slotFunc, FEnd&& endFunc,
+										  const char* pszName = nullptr)
+	{
+		return CreateTicks(
+			nInitialTicks, nTimerFlags, [nPeriodTicks, beginFunc, slotFunc, endFunc, iNextSlot = -1, nSweepStartTick = (uint64)0]() mutable {
+				if (iNextSlot == -1)
+				{
+					nSweepStartTick = g_nUniversalTick;
+
+					if (!beginFunc())
+						return nPeriodTicks;
+
+					iNextSlot = 0;
+				}
+
+				CTimeSliceBudget budget;
+				int iSlotCount = GetPlayerSweepSlotCount();
 
-	static std::weak_ptr<CTimer> Create(float flInitialInterval, uint64 nTimerFlags, std::function<float()> func);
-	bool Execute(bool bAutomaticExecute) override;
-	void Cancel() override;
+				while (iNextSlot < iSlotCount)
+				{
+					slotFunc(iNextSlot++);
+
+					if (iNextSlot < iSlotCount && budget.IsExhausted())
+						return 1;
+				}
+
+				endFunc();
+				iNextSlot = -1;
+
+				// Stay on the same phase no matter how many ticks the sweep was spread over
+				return std::max(nPeriodTicks - (int)(g_nUniversalTick - nSweepStartTick), 1);
+			},
+			pszName);
+	}
+
+	float GetInterval() { return m_flInterval; }
+	float GetLastExecute() { return m_flLastExecute; }
+	float GetNextExecute() { return m_flLastExecute + m_flInterval; }
+	uint64 GetNextExecuteTick() { return m_nLastExecuteTick + m_nTickInterval; }
+	bool IsTickBased() { return m_bTickBased; }
+	bool IsTimerFlagSet(uint64 iTimerFlag) { return !iTimerFlag || (m_nTimerFlags & iTimerFlag); }
+	bool IsActive() { return m_bActive; }
+	const char* GetName() { return m_pszName; }
+
+	void Cancel();
 
 private:
-	std::function<float()> m_func;
+	static CTimer* Allocate(uint64 nTimerFlags, const char* pszName, bool bTickBased);
+	static CTimerHandle Start(CTimer* pTimer);
+
+	bool Execute();
+
+	CTimerCallback m_func;
+	CTickTimerCallback m_tickFunc;
+	float m_flInterval = 0.0f;
+	float m_flLastExecute = -1;
+	int m_nTickInterval = 0;
+	uint64 m_nLastExecuteTick = 0;
+	bool m_bTickBased = false;
+	uint64 m_nTimerFlags = TIMERFLAG_NONE;
+	const char* m_pszName = nullptr;
+	TimerStats_t* m_pStats = nullptr;
+
+	// Pool and scheduler bookkeeping, see CTimerScheduler
+	uint32 m_iIndex = 0;
+	uint32 m_nGeneration = 0;
+	uint64 m_nScheduleSequence = 0;
+	bool m_bActive = false;
+	bool m_bExecuting = false;
 };
 
+// CS2 servers always simulate at 64 ticks per second
+#define TIMER_TICKS_PER_SECOND 64
+#define TIMER_SECONDS_TO_TICKS(seconds) ((int)((seconds) * TIMER_TICKS_PER_SECOND + 0.5f))
+
+// Ticks until the next tick where (tick % nPeriod) == nPhase, meant as the initial interval of periodic tick based timers
+// Giving systems that run at the same rate different phases keeps them on separate ticks instead of piling up on one
+int GetTicksUntilPhase(int nPeriod, int nPhase);
+
+CInlineCallback<void>* AllocateNextTick(uint64 nTimerFlags);
+
+// Runs the function once on the next Hook_GameFramePost, after entities have thought and right before timers run
+// Meant for work that only has to wait for the current frame to finish, it's a lot cheaper than a 0 interval timer
+// Queued work can't be cancelled individually, but RemoveTimers() drops it the same way as timers with matching flags
+template <class F>
+void RunNextTick(uint64 nTimerFlags, F&& func)
+{
+	AllocateNextTick(nTimerFlags)->Emplace(std::forward<F>(func));
+}
+
+void RunNextTickQueue();
 void RunTimers();
 void RemoveAllTimers();
-void RemoveTimers(uint64 iTimerFlag);
\ No newline at end of file
+void RemoveTimers(uint64 iTimerFlag);
@@ -572,7 +572,7 @@ bool IgnitePawn(CCSPlayerPawn* pPawn, float flDuration, CBaseEntity* pInflictor,
 		pPawn->m_flVelocityModifier = g_cvarBurnSlowdown.Get();
 
 		return g_cvarBurnInterval.Get();
-	});
+	}, "customio/burn");
 
 	return true;
 }
@@ -95,11 +95,9 @@ static void DelayInput(CBaseEntity* pCaller, const char* input, const char* para
 {
 	const auto eh = pCaller->GetHandle();
 
-	CTimer::Create(0.f, TIMERFLAG_MAP | TIMERFLAG_ROUND, [eh, input, param]() {
+	RunNextTick(TIMERFLAG_MAP | TIMERFLAG_ROUND, [eh, input, param]() {
 		if (const auto entity = reinterpret_cast<CBaseEntity*>(eh.Get()))
 			entity->AcceptInput(input, param, nullptr, entity);
-
-		return -1.f;
 	});
 }
 
@@ -109,12 +107,10 @@ static void DelayInput(CBaseEntity* pCaller, CBaseEntity* pActivator, const char
 	const auto eh = pCaller->GetHandle();
 	const auto ph = pActivator->GetHandle();
 
-	CTimer::Create(0.f, TIMERFLAG_MAP | TIMERFLAG_ROUND, [eh, ph, input, param]() {
+	RunNextTick(TIMERFLAG_MAP | TIMERFLAG_ROUND, [eh, ph, input, param]() {
 		const auto player = reinterpret_cast<CBaseEntity*>(ph.Get());
 		if (const auto entity = reinterpret_cast<CBaseEntity*>(eh.Get()))
 			entity->AcceptInput(input, param, player, entity);
-
-		return -1.f;
 	});
 }
 
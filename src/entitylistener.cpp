@@ -26,6 +26,7 @@
 #include "entwatch.h"
 #include "gameconfig.h"
 #include "plat.h"
+#include "playermanager.h"
 
 CEntityListener* g_pEntityListener = nullptr;
 
@@ -67,9 +68,11 @@ void CEntityListener::OnEntityCreated(CEntityInstance* pEntity)
 
 void CEntityListener::OnEntityDeleted(CEntityInstance* pEntity)
 {
+	g_playerManager->OnEntityDeleted(pEntity);
 	EW_OnEntityDeleted(pEntity);
 }
 
 void CEntityListener::OnEntityParentChanged(CEntityInstance* pEntity, CEntityInstance* pNewParent)
 {
+	g_playerManager->OnEntityParentChanged(pEntity, pNewParent);
 }
\ No newline at end of file
@@ -46,6 +46,7 @@
 #include "utils/entity.h"
 #include "vendor/nlohmann/json.hpp"
 #include "zombiereborn.h"
+#include <algorithm>
 #include <fstream>
 #include <sstream>
 
@@ -759,13 +760,13 @@ void EWItemInstance::FindExistingHandlers()
 /* Called when a player picks up this item */
 void EWItemInstance::Pickup(int slot)
 {
-	iOwnerSlot = slot;
+	g_pEWHandler->SetItemOwner(this, slot);
 
 	ZEPlayer* pPlayer = g_playerManager->GetPlayer(CPlayerSlot(iOwnerSlot));
 	CCSPlayerController* pController = CCSPlayerController::FromSlot(iOwnerSlot);
 	if (!pPlayer || !pController)
 	{
-		iOwnerSlot = -1;
+		g_pEWHandler->SetItemOwner(this, -1);
 		return;
 	}
 
@@ -784,15 +785,13 @@ void EWItemInstance::Pickup(int slot)
 	{
 		// Only set clantag if owner doesnt already have one set
 		bool bShouldSetClantag = true;
-		int otherItem = g_pEWHandler->FindItemInstanceByOwner(iOwnerSlot, false, 0);
-		while (otherItem != -1)
+		for (EWItemInstance* pOtherItem : g_pEWHandler->GetItemsByOwner(iOwnerSlot))
 		{
-			if (g_pEWHandler->vecItems[otherItem]->bHasThisClantag)
+			if (pOtherItem->bHasThisClantag)
 			{
 				bShouldSetClantag = false;
 				break;
 			}
-			otherItem = g_pEWHandler->FindItemInstanceByOwner(iOwnerSlot, false, otherItem + 1);
 		}
 
 		if (bShouldSetClantag)
@@ -821,7 +820,7 @@ void EWItemInstance::Drop(EWDropReason reason, CCSPlayerController* pController)
 	ZEPlayer* pPlayer = g_playerManager->GetPlayer(CPlayerSlot(iOwnerSlot));
 	if (!pPlayer)
 	{
-		iOwnerSlot = -1;
+		g_pEWHandler->SetItemOwner(this, -1);
 		return;
 	}
 
@@ -930,7 +929,7 @@ void EWItemInstance::Drop(EWDropReason reason, CCSPlayerController* pController)
 	if (g_cvarItemDroppedGlow.Get() > 0 && reason != EWDropReason::Deleted && bAllowDrop)
 		StartGlow();
 
-	iOwnerSlot = -1;
+	g_pEWHandler->SetItemOwner(this, -1);
 }
 
 std::string EWItemInstance::GetHandlerStateText()
@@ -998,7 +997,7 @@ void EWItemInstance::StartGlow()
 			pWep->m_Glow().m_bGlowing = true;
 		}
 		return -1.0f;
-	});
+	}, "entwatch/glow");
 }
 
 void EWItemInstance::EndGlow()
@@ -1073,6 +1072,7 @@ void CEWHandler::UnLoadConfig()
 	for (int i = 0; i < (vecItems).size(); i++)
 		for (int j = 0; j < (vecItems[i]->vecHandlers).size(); j++)
 			vecItems[i]->vecHandlers[j]->RemoveHook();
+	ClearItemOwners();
 	vecItems.clear();
 
 	RemoveAllUseHooks();
@@ -1214,9 +1214,43 @@ void CEWHandler::PrintLoadedConfig(CPlayerSlot slot)
 void CEWHandler::ClearItems()
 {
 	mapTransfers.clear();
+	ClearItemOwners();
 	vecItems.clear();
 }
 
+/*
+ *	Moves an item instance to a new owner slot (-1 for none), keeping the holder mask and per-owner index in sync
+ *  Every change of iOwnerSlot should go through here
+ */
+void CEWHandler::SetItemOwner(EWItemInstance* pItem, int iSlot)
+{
+	int iOldSlot = pItem->iOwnerSlot;
+	pItem->iOwnerSlot = iSlot;
+
+	if (iOldSlot >= 0 && iOldSlot < MAXPLAYERS)
+	{
+		std::vector<EWItemInstance*>& vecOwned = m_vecOwnerItems[iOldSlot];
+		vecOwned.erase(std::remove(vecOwned.begin(), vecOwned.end(), pItem), vecOwned.end());
+
+		if (vecOwned.empty())
+			m_iItemHolderMask &= ~(1ull << iOldSlot);
+	}
+
+	if (iSlot >= 0 && iSlot < MAXPLAYERS)
+	{
+		m_vecOwnerItems[iSlot].push_back(pItem);
+		m_iItemHolderMask |= 1ull << iSlot;
+	}
+}
+
+void CEWHandler::ClearItemOwners()
+{
+	for (int i = 0; i < MAXPLAYERS; i++)
+		m_vecOwnerItems[i].clear();
+
+	m_iItemHolderMask = 0;
+}
+
 /*
  *	Finds the index of an item instance with a given entity index
  *  Returns index into vecItems or -1 if not found
@@ -1600,6 +1634,9 @@ void CEWHandler::RemoveWeaponFromItem(int itemId)
 		CCSPlayerController* pOwner = CCSPlayerController::FromSlot(CPlayerSlot(pItem->iOwnerSlot));
 		if (pOwner)
 			pItem->Drop(EWDropReason::Deleted, pOwner);
+
+		// Owner controller is already gone, still nobody is holding it anymore
+		SetItemOwner(pItem.get(), -1);
 	}
 
 	pItem->iWeaponEnt = -1;
@@ -1621,9 +1658,11 @@ void CEWHandler::PlayerPickup(CCSPlayerPawn* pPawn, int iItemInstance)
 	if (g_cvarEnableEntwatchHud.Get() && !m_bHudTicking)
 	{
 		m_bHudTicking = true;
-		CTimer::Create(EW_HUD_TICKRATE, TIMERFLAG_MAP | TIMERFLAG_ROUND, [] {
-			return EW_UpdateHud();
-		});
+		CTimer::CreatePlayerSweep(
+			EW_HUD_TICKRATE, GetTicksUntilPhase(EW_HUD_TICKRATE, EW_HUD_PHASE), TIMERFLAG_MAP | TIMERFLAG_ROUND,
+			[] { return EW_UpdateHudText(); },
+			[](int iSlot) { EW_UpdateHud(iSlot); },
+			[] {}, "entwatch/hud");
 	}
 }
 
@@ -1650,14 +1689,10 @@ void CEWHandler::PlayerDrop(EWDropReason reason, int iItemInstance, CCSPlayerCon
 	}
 	else
 	{
-		// Find all items owned by this player
-		for (int i = 0; i < (vecItems).size(); i++)
-		{
-			if (vecItems[i]->iOwnerSlot != pController->GetPlayerSlot())
-				continue;
-
-			vecItems[i]->Drop(reason, pController);
-		}
+		// Drop all items owned by this player, copied since dropping updates the index
+		std::vector<EWItemInstance*> vecOwned = GetItemsByOwner(pController->GetPlayerSlot());
+		for (EWItemInstance* pItem : vecOwned)
+			pItem->Drop(reason, pController);
 	}
 }
 
@@ -1945,14 +1980,17 @@ void CEWHandler::Hook_Use(InputData_t* pInput)
 	RETURN_META(MRES_IGNORED);
 }
 
-// Update cd and uses of all held items
-float EW_UpdateHud()
+static std::string g_sHudText;
+static std::string g_sHudTextNoPlayerNames;
+
+// Rebuild the hud text with cd and uses of all held items, returns false if there's no need to send it out
+bool EW_UpdateHudText()
 {
 	if (!GetGlobals())
-		return EW_HUD_TICKRATE;
+		return false;
 
-	std::string sHudText = "";
-	std::string sHudTextNoPlayerNames = "";
+	g_sHudText.clear();
+	g_sHudTextNoPlayerNames.clear();
 	static bool bWasEmptyPreviously = false;
 
 	bool bFirst = true;
@@ -1975,67 +2013,64 @@ float EW_UpdateHud()
 		std::string sItemText = pItem->GetHandlerStateText();
 
 		// TODO: std::format not supported in clang16 by default
-		// sHudText.append(std::format("\n[{}]{}: {}", sItemText, pItem->szShortName, pOwner->GetPlayerName()));
+		// g_sHudText.append(std::format("\n[{}]{}: {}", sItemText, pItem->szShortName, pOwner->GetPlayerName()));
 		if (!bFirst)
 		{
-			sHudText.append("\n");
-			sHudTextNoPlayerNames.append("\n");
+			g_sHudText.append("\n");
+			g_sHudTextNoPlayerNames.append("\n");
 		}
 		else
 			bFirst = false;
 
-		sHudText.append("[");
-		sHudText.append(sItemText);
-		sHudText.append("]");
-		sHudText.append(pItem->szShortName);
-		sHudText.append(": ");
-		sHudText.append(pOwner->GetPlayerName());
+		g_sHudText.append("[");
+		g_sHudText.append(sItemText);
+		g_sHudText.append("]");
+		g_sHudText.append(pItem->szShortName);
+		g_sHudText.append(": ");
+		g_sHudText.append(pOwner->GetPlayerName());
 
-		// sHudTextNoPlayerNames.append(std::format("\n[{}]{}", sItemText, pItem->szShortName));
-		sHudTextNoPlayerNames.append("[");
-		sHudTextNoPlayerNames.append(sItemText);
-		sHudTextNoPlayerNames.append("]");
-		sHudTextNoPlayerNames.append(pItem->szShortName);
+		// g_sHudTextNoPlayerNames.append(std::format("\n[{}]{}", sItemText, pItem->szShortName));
+		g_sHudTextNoPlayerNames.append("[");
+		g_sHudTextNoPlayerNames.append(sItemText);
+		g_sHudTextNoPlayerNames.append("]");
+		g_sHudTextNoPlayerNames.append(pItem->szShortName);
 	}
 
-	if (sHudText != "")
+	if (g_sHudText != "")
 	{
 		bWasEmptyPreviously = false;
 	}
 	else
 	{
 		if (bWasEmptyPreviously)
-			return EW_HUD_TICKRATE;
+			return false;
 		bWasEmptyPreviously = true;
 	}
 
-	for (int i = 0; i < GetGlobals()->maxClients; i++)
-	{
-		CCSPlayerController* pController = CCSPlayerController::FromSlot(i);
-		if (!pController)
-			continue;
-		auto pPawn = pController->GetPawn();
-		if (!pPawn)
-			continue;
-		ZEPlayer* zpPlayer = g_playerManager->GetPlayer(CPlayerSlot(i));
-		if (!zpPlayer)
-			continue;
+	return true;
+}
 
-		EWHudMode mode = (EWHudMode)(zpPlayer->GetEntwatchHudMode());
+// Send the hud text built by EW_UpdateHudText to a single player
+void EW_UpdateHud(int iSlot)
+{
+	if (!g_playerManager->GetSnapshot().m_pPawn[iSlot])
+		return;
+	ZEPlayer* zpPlayer = g_playerManager->GetPlayer(CPlayerSlot(iSlot));
+	if (!zpPlayer)
+		return;
 
-		CPointWorldText* pText = zpPlayer->GetEntwatchHud();
-		if (!pText)
-			continue;
+	EWHudMode mode = (EWHudMode)(zpPlayer->GetEntwatchHudMode());
 
-		if (mode == EWHudMode::Hud_On)
-			pText->AcceptInput("SetMessage", sHudText.c_str());
-		else if (mode == EWHudMode::Hud_ItemOnly)
-			pText->AcceptInput("SetMessage", sHudTextNoPlayerNames.c_str());
-		else
-			pText->AcceptInput("SetMessage", "");
-	}
+	CPointWorldText* pText = zpPlayer->GetEntwatchHud();
+	if (!pText)
+		return;
 
-	return EW_HUD_TICKRATE;
+	if (mode == EWHudMode::Hud_On)
+		pText->AcceptInput("SetMessage", g_sHudText.c_str());
+	else if (mode == EWHudMode::Hud_ItemOnly)
+		pText->AcceptInput("SetMessage", g_sHudTextNoPlayerNames.c_str());
+	else
+		pText->AcceptInput("SetMessage", "");
 }
 
 void EW_OnLevelInit(const char* sMapName)
@@ -2077,7 +2112,7 @@ void EW_OnEntitySpawned(CEntityInstance* pEntity)
 				if (item)
 					item->FindExistingHandlers();
 				return -1.0f;
-			});
+			}, "entwatch/find_handlers");
 		}
 		return;
 	}
@@ -2097,7 +2132,7 @@ void EW_OnEntitySpawned(CEntityInstance* pEntity)
 		if (hEntity.Get())
 			g_pEWHandler->RegisterHandler(hEntity.Get());
 		return -1.0;
-	});
+	}, "entwatch/spawn");
 }
 
 void EW_OnEntityDeleted(CEntityInstance* pEntity)
@@ -47,7 +47,9 @@ extern CConVar<bool> g_cvarEnableEntwatchHud;
 
 #define EW_HUDSIZE_DEFAULT 60.0f
 
-#define EW_HUD_TICKRATE 0.5f
+// In ticks, the phase keeps the hud sweep off the ticks the infinite ammo and infraction sweeps start on (phases 8 and 4)
+#define EW_HUD_TICKRATE 32
+#define EW_HUD_PHASE 16
 
 enum EWHandlerType
 {
@@ -213,6 +215,7 @@ public:
 	{
 		bConfigLoaded = false;
 		m_bHudTicking = false;
+		m_iItemHolderMask = 0;
 
 		iBaseBtnUseHookId = -1;
 		iPhysboxUseHookId = -1;
@@ -244,6 +247,11 @@ public:
 	int FindItemInstanceByOwner(int iOwnerSlot, bool bOnlyTransferrable, int iStartItem);
 	int FindItemInstanceByName(std::string sItemName, bool bOnlyTransferrable, bool bExact, int iStartItem);
 
+	void SetItemOwner(EWItemInstance* pItem, int iSlot);
+	void ClearItemOwners();
+	bool IsItemHolder(int iSlot) { return iSlot >= 0 && iSlot < MAXPLAYERS && (m_iItemHolderMask & (1ull << iSlot)); }
+	const std::vector<EWItemInstance*>& GetItemsByOwner(int iSlot) { return m_vecOwnerItems[iSlot]; }
+
 	void RegisterHandler(CBaseEntity* pEnt);
 	bool RegisterTrigger(CBaseEntity* pEnt);
 	void AddTouchHook(CBaseEntity* pEnt);
@@ -281,6 +289,9 @@ public:
 
 	bool m_bHudTicking;
 
+	uint64 m_iItemHolderMask;								  /* bit per slot currently holding at least one item */
+	std::vector<EWItemInstance*> m_vecOwnerItems[MAXPLAYERS]; /* items held by each slot, owned by vecItems */
+
 	std::map<int, std::shared_ptr<ETransferInfo>> mapTransfers; // Any etransfers that target multiple items
 };
 
@@ -301,4 +312,5 @@ void EW_UpdateClientClanTags();
 bool EW_IsFireOutputHooked();
 void EW_FireOutput(const CEntityIOOutput* pThis, CEntityInstance* pActivator, CEntityInstance* pCaller, const CVariant* value, float flDelay);
 int GetTemplateSuffixNumber(const char* szName);
-float EW_UpdateHud();
\ No newline at end of file
+bool EW_UpdateHudText();
+void EW_UpdateHud(int iSlot);
\ No newline at end of file
@@ -90,6 +90,12 @@ CConVar<bool> g_cvarBlockTeamMessages("cs2f_block_team_messages", FCVAR_NONE, "W
 
 GAME_EVENT_F(player_team)
 {
+	CCSPlayerController* pController = (CCSPlayerController*)pEvent->GetPlayerController("userid");
+
+	// The controller's team isn't updated until after the event fires
+	if (pController && !pEvent->GetBool("disconnect"))
+		g_playerManager->SetPlayerTeam(pController->GetPlayerSlot(), pEvent->GetInt("team"));
+
 	// Remove chat message for team changes
 	if (g_cvarBlockTeamMessages.Get())
 		pEvent->SetBool("silent", true);
@@ -111,6 +117,10 @@ GAME_EVENT_F(player_spawn)
 	if (pPlayer)
 		pPlayer->SetMaxSpeed(1.f);
 
+	g_playerManager->SetPlayerPawn(pController->GetPlayerSlot(), pController->GetPlayerPawn());
+	g_playerManager->SetPlayerTeam(pController->GetPlayerSlot(), pController->m_iTeamNum);
+	g_playerManager->SetPlayerAlive(pController->GetPlayerSlot(), pController->m_iTeamNum >= CS_TEAM_T);
+
 	if (g_cvarEnableZR.Get())
 		ZR_OnPlayerSpawn(pController);
 
@@ -120,27 +130,25 @@ GAME_EVENT_F(player_spawn)
 	CHandle<CCSPlayerController> hController = pController->GetHandle();
 
 	// Gotta do this on the next frame...
-	CTimer::Create(0.0f, TIMERFLAG_MAP | TIMERFLAG_ROUND, [hController]() {
+	RunNextTick(TIMERFLAG_MAP | TIMERFLAG_ROUND, [hController]() {
 		CCSPlayerController* pController = hController.Get();
 
 		if (!pController)
-			return -1.0f;
+			return;
 
 		if (const auto player = pController->GetZEPlayer())
 			player->SetSteamIdAttribute();
 
 		if (!pController->m_bPawnIsAlive())
-			return -1.0f;
+			return;
 
 		CBasePlayerPawn* pPawn = pController->GetPawn();
 
 		// Just in case somehow there's health but the player is, say, an observer
 		if (!g_cvarNoblock.Get() || !pPawn || !pPawn->IsAlive())
-			return -1.0f;
+			return;
 
 		pPawn->SetCollisionGroup(COLLISION_GROUP_DEBRIS);
-
-		return -1.0f;
 	});
 
 	CCSPlayerPawn* pPawn = (CCSPlayerPawn*)pController->GetPawn();
@@ -185,6 +193,12 @@ GAME_EVENT_F(player_hurt)
 
 GAME_EVENT_F(player_death)
 {
+	CCSPlayerController* pVictim = (CCSPlayerController*)pEvent->GetPlayerController("userid");
+
+	// ZR's infection deaths are fake, the pawn stays alive and just changes team
+	if (pVictim && !pEvent->GetBool("infected"))
+		g_playerManager->SetPlayerAlive(pVictim->GetPlayerSlot(), false);
+
 	if (g_cvarEnableZR.Get())
 		ZR_OnPlayerDeath(pEvent);
 
@@ -195,7 +209,6 @@ GAME_EVENT_F(player_death)
 		return;
 
 	CCSPlayerController* pAttacker = (CCSPlayerController*)pEvent->GetPlayerController("attacker");
-	CCSPlayerController* pVictim = (CCSPlayerController*)pEvent->GetPlayerController("userid");
 
 	// Ignore Ts/zombie kills and ignore CT teamkilling or suicide
 	if (!pAttacker || !pVictim || pAttacker->m_iTeamNum != CS_TEAM_CT || pAttacker->m_iTeamNum == pVictim->m_iTeamNum)
@@ -1,6 +1,16 @@
 #include "gameconfig.h"
 #include "addresses.h"
 
+#include "vendor/nlohmann/json.hpp"
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <thread>
+#include <vector>
+
+using ordered_json = nlohmann::ordered_json;
+
 CGameConfig* g_GameConfig = nullptr;
 
 CGameConfig::CGameConfig(const std::string& gameDir, const std::string& path)
@@ -48,6 +58,7 @@ bool CGameConfig::Init(IFileSystem* filesystem, char* conf_error, int conf_error
 			{
 				m_umLibraries[it->GetName()] = std::string(it->GetString("library"));
 				m_umSignatures[it->GetName()] = std::string(it->GetString(platform));
+				m_umSignatureSections[it->GetName()] = std::string(it->GetString("section"));
 			}
 		}
 
@@ -81,6 +92,15 @@ const char* CGameConfig::GetSignature(const std::string& name)
 	return it->second.c_str();
 }
 
+// The gamedata "section" key of a signature, or an empty string which means .text
+const char* CGameConfig::GetSignatureSection(const std::string& name)
+{
+	auto it = m_umSignatureSections.find(name);
+	if (it == m_umSignatureSections.end())
+		return "";
+	return it->second.c_str();
+}
+
 const char* CGameConfig::GetPatch(const std::string& name)
 {
 	auto it = m_umPatches.find(name);
@@ -184,17 +204,34 @@ void* CGameConfig::ResolveSignature(const char* name)
 			return nullptr;
 		}
 
-		size_t iLength = 0;
-		byte* pSignature = HexToByte(signature, iLength);
-		if (!pSignature)
-			return nullptr;
+		// Most signatures were already found by ResolveAllSignatures
+		auto it = m_umResolvedSignatures.find(name);
 
-		int error;
+		if (it != m_umResolvedSignatures.end())
+		{
+			address = it->second.m_pAddress;
 
-		address = (*module)->FindSignature(pSignature, iLength, error);
+			if (it->second.m_bMultiple)
+				Panic("!!!!!!!!!! Signature for %s occurs multiple times! Using first match but this might end up crashing!\n", name);
+		}
+		else
+		{
+			size_t iLength = 0;
+			byte* pSignature = HexToByte(signature, iLength);
+			if (!pSignature)
+				return nullptr;
 
-		if (error == SIG_FOUND_MULTIPLE)
-			Panic("!!!!!!!!!! Signature for %s occurs multiple times! Using first match but this might end up crashing!\n", name);
+			int error;
+			double flStart = Plat_FloatTime();
+
+			address = (*module)->FindSignature(pSignature, iLength, error, GetSignatureSection(name));
+			delete[] pSignature;
+
+			Message("Scanned for %s on its own in %.2f ms\n", name, (Plat_FloatTime() - flStart) * 1000.0);
+
+			if (error == SIG_FOUND_MULTIPLE)
+				Panic("!!!!!!!!!! Signature for %s occurs multiple times! Using first match but this might end up crashing!\n", name);
+		}
 	}
 
 	if (!address)
@@ -205,6 +242,199 @@ void* CGameConfig::ResolveSignature(const char* name)
 	return address;
 }
 
+// Found signatures are cached per module build, as offsets from the module base along with a hash of the signature they came from
+// So editing one signature in the gamedata only invalidates that one, and a game update invalidates the whole module
+#define SIGNATURE_CACHE_PATH "addons/cs2fixes/data/signature_cache.jsonc"
+#define SIGNATURE_CACHE_VERSION 1
+
+static uint64_t HashSignature(const std::string& signature)
+{
+	uint64_t hash = 0xcbf29ce484222325;
+
+	for (char c : signature)
+		hash = (hash ^ (uint8_t)c) * 0x100000001b3;
+
+	return hash;
+}
+
+static ordered_json LoadSignatureCache()
+{
+	char szPath[MAX_PATH];
+	V_snprintf(szPath, sizeof(szPath), "%s%s%s", Plat_GetGameDirectory(), "/csgo/", SIGNATURE_CACHE_PATH);
+	std::ifstream cacheFile(szPath);
+
+	if (!cacheFile.is_open())
+		return ordered_json();
+
+	ordered_json jsonCache = ordered_json::parse(cacheFile, nullptr, false, true);
+
+	if (jsonCache.is_discarded() || jsonCache.value("Version", 0) != SIGNATURE_CACHE_VERSION)
+		return ordered_json();
+
+	return jsonCache;
+}
+
+// The cached signatures of a module, or nothing if they were cached for another build of it
+static ordered_json GetCachedModuleSignatures(const ordered_json& jsonCache, const char* pszModule, const std::string& buildId)
+{
+	if (buildId.empty() || !jsonCache.contains("Modules") || !jsonCache["Modules"].contains(pszModule))
+		return ordered_json();
+
+	const ordered_json& jsonModule = jsonCache["Modules"][pszModule];
+
+	if (!jsonModule.is_object() || jsonModule.value("BuildId", "") != buildId || !jsonModule.contains("Signatures"))
+		return ordered_json();
+
+	return jsonModule["Signatures"];
+}
+
+// Scan every module once for all the signatures that target it, rather than once per signature
+// Results are kept for ResolveSignature, so this has to run after the modules are loaded but before anything gets patched
+void CGameConfig::ResolveAllSignatures()
+{
+	double flStart = Plat_FloatTime();
+
+	ordered_json jsonCache = LoadSignatureCache();
+	std::unordered_map<CModule*, std::string> mapModuleBuildIds;
+	std::unordered_map<CModule*, ordered_json> mapModuleCache;
+
+	// One pass per module section, most signatures share .text
+	using ScanTarget_t = std::pair<CModule*, std::string>;
+	std::map<ScanTarget_t, std::vector<const std::string*>> mapTargetSignatures;
+	std::map<ScanTarget_t, CMultiSignatureScanner> mapTargetScanners;
+	int nCacheHits = 0;
+
+	for (const auto& [name, signature] : m_umSignatures)
+	{
+		if (signature.empty() || signature[0] == '@')
+			continue;
+
+		CModule** module = GetModule(name.c_str());
+
+		// Leave the error reporting to ResolveSignature, in case this one is never used
+		if (!module || !(*module))
+			continue;
+
+		size_t iLength = 0;
+		byte* pSignature = HexToByte(signature.c_str(), iLength);
+		if (!pSignature)
+			continue;
+
+		CModule* pModule = *module;
+		const char* pszSection = GetSignatureSection(name);
+
+		const byte* pSectionBegin;
+		const byte* pSectionEnd;
+		pModule->GetSignatureScanRange(pszSection, pSectionBegin, pSectionEnd);
+
+		if (!mapModuleBuildIds.contains(pModule))
+		{
+			mapModuleBuildIds[pModule] = pModule->GetBuildId();
+			mapModuleCache[pModule] = GetCachedModuleSignatures(jsonCache, pModule->m_pszModule, mapModuleBuildIds[pModule]);
+		}
+
+		// A cached offset only counts if the build and signature are unchanged and the bytes there still match
+		const ordered_json& jsonSignatures = mapModuleCache[pModule];
+		ordered_json jsonEntry = jsonSignatures.contains(name) ? jsonSignatures[name] : ordered_json();
+
+		if (jsonEntry.is_object() && jsonEntry["Hash"].is_number_unsigned() && jsonEntry["Offset"].is_number_integer() && jsonEntry["Multiple"].is_boolean() &&
+			jsonEntry["Hash"].get<uint64_t>() == HashSignature(signature))
+		{
+			double flVerifyStart = Plat_FloatTime();
+
+			// Signed, sections other than .text can come before the module base on Linux
+			const byte* pCached = (byte*)pModule->m_base + jsonEntry["Offset"].get<int64_t>();
+
+			bool bValid = pCached >= pSectionBegin && pCached <= pSectionEnd && iLength <= (size_t)(pSectionEnd - pCached) &&
+						  CSignatureScanner(pSignature, iLength, true).Matches(pCached);
+
+			double flVerifyTime = (Plat_FloatTime() - flVerifyStart) * 1000.0;
+
+			if (bValid)
+			{
+				Message("Verified cached %s in %.3f ms\n", name.c_str(), flVerifyTime);
+
+				m_umResolvedSignatures[name] = {(void*)pCached, jsonEntry["Multiple"].get<bool>()};
+				nCacheHits++;
+
+				delete[] pSignature;
+				continue;
+			}
+
+			Message("Cached %s no longer matches, checked in %.3f ms, rescanning\n", name.c_str(), flVerifyTime);
+		}
+
+		ScanTarget_t target(pModule, pszSection);
+		mapTargetScanners[target].AddPattern(pSignature, iLength, true);
+		mapTargetSignatures[target].push_back(&name);
+
+		delete[] pSignature;
+	}
+
+	int nThreads = std::clamp((int)std::thread::hardware_concurrency(), 1, 8);
+
+	for (const auto& [target, scanner] : mapTargetScanners)
+	{
+		const auto& [pModule, section] = target;
+		const std::vector<const std::string*>& vecNames = mapTargetSignatures[target];
+
+		const byte* pBegin;
+		const byte* pEnd;
+		pModule->GetSignatureScanRange(section.c_str(), pBegin, pEnd);
+
+		double flScanStart = Plat_FloatTime();
+		std::vector<CMultiSignatureScanner::Result_t> vecResults = scanner.Scan(pBegin, pEnd, nThreads);
+		double flScanTime = (Plat_FloatTime() - flScanStart) * 1000.0;
+
+		// Everything is found in the same pass, so its cost is only known for the whole pass
+		Message("Scanned %.1f MB of %s %s for %i signatures in one pass in %.2f ms\n", (pEnd - pBegin) / (1024.0 * 1024.0), pModule->m_pszModule,
+				section.empty() ? ".text" : section.c_str(), (int)vecNames.size(), flScanTime);
+
+		for (size_t i = 0; i < vecResults.size(); i++)
+			m_umResolvedSignatures[*vecNames[i]] = {(void*)vecResults[i].m_pFirst, vecResults[i].m_nMatches > 1};
+	}
+
+	Message("Resolved %i signatures (%i cached) with %i section scans in %.2f ms\n", (int)m_umResolvedSignatures.size(), nCacheHits,
+			(int)mapTargetScanners.size(), (Plat_FloatTime() - flStart) * 1000.0);
+
+	// Nothing new was learned, keep the file as it is
+	if (mapTargetScanners.empty())
+		return;
+
+	ordered_json jsonNewCache;
+	jsonNewCache["Version"] = SIGNATURE_CACHE_VERSION;
+	jsonNewCache["Modules"] = ordered_json(ordered_json::value_t::object);
+
+	for (const auto& [name, resolved] : m_umResolvedSignatures)
+	{
+		CModule* pModule = *GetModule(name.c_str());
+
+		// Without a build ID there's no telling when the offset goes stale, and misses have nothing to validate against
+		if (mapModuleBuildIds[pModule].empty() || !resolved.m_pAddress)
+			continue;
+
+		ordered_json& jsonModule = jsonNewCache["Modules"][pModule->m_pszModule];
+		jsonModule["BuildId"] = mapModuleBuildIds[pModule];
+
+		ordered_json& jsonEntry = jsonModule["Signatures"][name];
+		jsonEntry["Hash"] = HashSignature(m_umSignatures[name]);
+		jsonEntry["Offset"] = (int64_t)((byte*)resolved.m_pAddress - (byte*)pModule->m_base);
+		jsonEntry["Multiple"] = resolved.m_bMultiple;
+	}
+
+	char szPath[MAX_PATH];
+	V_snprintf(szPath, sizeof(szPath), "%s%s%s", Plat_GetGameDirectory(), "/csgo/", SIGNATURE_CACHE_PATH);
+	std::ofstream cacheFile(szPath);
+
+	if (!cacheFile.is_open())
+	{
+		Warning("Failed to write signature cache to %s\n", SIGNATURE_CACHE_PATH);
+		return;
+	}
+
+	cacheFile << std::setfill('\t') << std::setw(1) << jsonNewCache << std::endl;
+}
+
 // Static functions
 std::string CGameConfig::GetDirectoryName(const std::string& directoryPathInput)
 {
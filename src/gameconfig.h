@@ -18,6 +18,7 @@ public:
 	const std::string GetPath();
 	const char* GetLibrary(const std::string& name);
 	const char* GetSignature(const std::string& name);
+	const char* GetSignatureSection(const std::string& name);
 	const char* GetSymbol(const char* name);
 	const char* GetPatch(const std::string& name);
 	int GetOffset(const std::string& name);
@@ -25,17 +26,25 @@ public:
 	CModule** GetModule(const char* name);
 	bool IsSymbol(const char* name);
 	void* ResolveSignature(const char* name);
+	void ResolveAllSignatures();
 	static std::string GetDirectoryName(const std::string& directoryPathInput);
 	static int HexStringToUint8Array(const char* hexString, uint8_t* byteArray, size_t maxBytes);
 	static byte* HexToByte(const char* src, size_t& length);
 
 private:
+	struct ResolvedSignature_t
+	{
+		void* m_pAddress;
+		bool m_bMultiple;
+	};
+
 	std::string m_szGameDir;
 	std::string m_szPath;
 	KeyValues* m_pKeyValues;
 	std::unordered_map<std::string, int> m_umOffsets;
 	std::unordered_map<std::string, std::string> m_umSignatures;
-	std::unordered_map<std::string, void*> m_umAddresses;
+	std::unordered_map<std::string, std::string> m_umSignatureSections;
+	std::unordered_map<std::string, ResolvedSignature_t> m_umResolvedSignatures;
 	std::unordered_map<std::string, std::string> m_umLibraries;
 	std::unordered_map<std::string, std::string> m_umPatches;
 };
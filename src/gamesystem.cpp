@@ -170,7 +170,9 @@ GS_EVENT_MEMBER(CGameSystem, BuildGameSessionManifest)
 GS_EVENT_MEMBER(CGameSystem, ServerPreEntityThink)
 {
 	VPROF_BUDGET("CGameSystem::ServerPreEntityThink", "CS2FixesPerFrame")
+	g_playerManager->UpdateSnapshot();
 	g_playerManager->FlashLightThink();
+	g_playerManager->CheckHideDistances();
 	g_pIdleSystem->UpdateIdleTimes();
 
 	if (GetGlobals())
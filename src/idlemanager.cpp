@@ -81,33 +81,21 @@ void CIdleSystem::CheckForIdleClients()
 // Logged inputs and time for the logged inputs are updated every time this function is run.
 void CIdleSystem::UpdateIdleTimes()
 {
-	if (g_cvarIdleKickTime.Get() <= 0.0f || !GetGlobals())
+	if (g_cvarIdleKickTime.Get() <= 0.0f)
 		return;
 
 	VPROF("CIdleSystem::UpdateIdleTimes");
 
-	for (int i = 0; i < GetGlobals()->maxClients; i++)
+	const PlayerSnapshot_t& snapshot = g_playerManager->GetSnapshot();
+
+	for (int i = 0; i < snapshot.m_iMaxClients; i++)
 	{
 		ZEPlayer* pPlayer = g_playerManager->GetPlayer(i);
 
-		if (!pPlayer)
-			continue;
-
-		CBasePlayerController* pTarget = (CBasePlayerController*)g_pEntitySystem->GetEntityInstance((CEntityIndex)(pPlayer->GetPlayerSlot().Get() + 1));
-		if (!pTarget)
+		if (!pPlayer || !snapshot.m_pPawn[i])
 			continue;
 
-		const auto pPawn = pTarget->m_hPawn();
-		if (!pPawn)
-			continue;
-
-		const auto pMovement = pPawn->m_pMovementServices();
-		uint64 iCurrentMovement = IN_NONE;
-		if (pMovement)
-		{
-			const auto buttonStates = pMovement->m_nButtons().m_pButtonStates();
-			iCurrentMovement = buttonStates[0];
-		}
+		uint64 iCurrentMovement = snapshot.m_nButtons[i];
 		const auto buttonsChanged = pPlayer->GetLastInputs() ^ iCurrentMovement;
 
 		if (!buttonsChanged)
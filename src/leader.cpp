@@ -21,8 +21,10 @@
 #include "commands.h"
 #include "common.h"
 #include "gameevents.pb.h"
+#include "netevents.h"
 #include "networksystem/inetworkmessages.h"
 #include "zombiereborn.h"
+#include <bit>
 
 #include "tier0/memdbgon.h"
 
@@ -62,15 +64,12 @@ CConVar<bool> g_cvarEnableLeader(
 			return;
 
 		// Remove all active leaders if disabling convar
-		for (int i = 0; i < GetGlobals()->maxClients; i++)
+		for (uint64 iLeaderMask = g_playerManager->GetLeaderMask(); iLeaderMask; iLeaderMask &= iLeaderMask - 1)
 		{
-			CCSPlayerController* ccsPly = CCSPlayerController::FromSlot(i);
-			ZEPlayer* pPlayer = g_playerManager->GetPlayer(i);
+			CCSPlayerController* ccsPly = CCSPlayerController::FromSlot(std::countr_zero(iLeaderMask));
 
-			if (!ccsPly || !pPlayer || !pPlayer->IsLeader())
-				continue;
-
-			RemoveLeader(ccsPly);
+			if (ccsPly)
+				RemoveLeader(ccsPly);
 		}
 	});
 
@@ -334,7 +333,7 @@ static bool Leader_CreateDefendMarker(ZEPlayer* pPlayer, Color clrTint, int iDur
 			g_iMarkerCount--;
 
 		return -1.0f;
-	});
+	}, "leader/marker");
 
 	CParticleSystem* pMarker = CreateEntityByName<CParticleSystem>("info_particle_system");
 
@@ -357,12 +356,12 @@ static bool Leader_CreateDefendMarker(ZEPlayer* pPlayer, Color clrTint, int iDur
 	return true;
 }
 
-void Leader_PostEventAbstract_Source1LegacyGameEvent(const uint64* clients, const CNetMessage* pData)
+POST_EVENT_F(GE_Source1LegacyGameEvent)
 {
 	if (!g_cvarEnableLeader.Get())
 		return;
 
-	auto pPBData = pData->ToPB<CMsgSource1LegacyGameEvent>();
+	auto pPBData = context.pData->ToPB<CMsgSource1LegacyGameEvent>();
 
 	static int player_ping_id = g_gameEventManager->LookupEventId("player_ping");
 
@@ -387,7 +386,7 @@ void Leader_PostEventAbstract_Source1LegacyGameEvent(const uint64* clients, cons
 	if (bNoHumanLeaders)
 	{
 		if (g_cvarMuteNonLeaderPings.Get())
-			*(uint64*)clients = 0;
+			*context.pClients = 0;
 
 		return;
 	}
@@ -422,7 +421,7 @@ void Leader_PostEventAbstract_Source1LegacyGameEvent(const uint64* clients, cons
 	if (pController->m_iTeamNum == CS_TEAM_T || g_bPingWithLeader)
 	{
 		if (g_cvarMuteNonLeaderPings.Get())
-			*(uint64*)clients = 0;
+			*context.pClients = 0;
 
 		return;
 	}
@@ -431,7 +430,7 @@ void Leader_PostEventAbstract_Source1LegacyGameEvent(const uint64* clients, cons
 	pEntity->Remove();
 
 	// Block clients from playing the ping sound
-	*(uint64*)clients = 0;
+	*context.pClients = 0;
 }
 
 void Leader_OnRoundStart(IGameEvent* pEvent)
@@ -462,20 +461,15 @@ void Leader_OnRoundStart(IGameEvent* pEvent)
 	// Apply visuals after in seperate for loop, since we have to worry about non-leaders
 	// that had visuals on being included in GetCount otherwise (which they shouldn't count
 	// towards since their visuals dont persist across round change).
-	for (int i = 0; i < GetGlobals()->maxClients; i++)
+	for (uint64 iLeaderMask = g_playerManager->GetLeaderMask(); iLeaderMask; iLeaderMask &= iLeaderMask - 1)
 	{
-		CCSPlayerController* pLeader = CCSPlayerController::FromSlot((CPlayerSlot)i);
+		CCSPlayerController* pLeader = CCSPlayerController::FromSlot(std::countr_zero(iLeaderMask));
 		if (!pLeader)
 			continue;
 
 		CCSPlayerPawn* pawnLeader = (CCSPlayerPawn*)pLeader->GetPawn();
 
-		if (!pawnLeader)
-			continue;
-
-		ZEPlayer* zpLeader = g_playerManager->GetPlayer((CPlayerSlot)i);
-
-		if (zpLeader && zpLeader->IsLeader())
+		if (pawnLeader)
 			Leader_ApplyLeaderVisuals(pawnLeader);
 	}
 
@@ -44,7 +44,6 @@ struct ColorPreset
 extern std::map<std::string, ColorPreset> mapColorPresets;
 
 void Leader_ApplyLeaderVisuals(CCSPlayerPawn* pPawn);
-void Leader_PostEventAbstract_Source1LegacyGameEvent(const uint64* clients, const CNetMessage* pData);
 void Leader_OnRoundStart(IGameEvent* pEvent);
 void Leader_BulletImpact(IGameEvent* pEvent);
 void Leader_Precache(IEntityResourceManifest* pResourceManifest);
\ No newline at end of file
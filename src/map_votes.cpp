@@ -69,7 +69,7 @@ CON_COMMAND_CHAT_FLAGS(map, "<name/id> - Change map", ADMFLAG_CHANGEMAP)
 		CTimer::Create(5.0f, TIMERFLAG_MAP, [pMap]() {
 			pMap->Load();
 			return -1.0f;
-		});
+		}, "mapvote/force_map");
 
 		ClientPrintAll(HUD_PRINTTALK, CHAT_PREFIX "Changing map to \x06%s\x01...", pMap->GetName());
 	});
@@ -227,7 +227,7 @@ void CMapVoteSystem::OnLevelInit(const char* pszMapName)
 		g_pEngineServer2->ServerCommand("mp_endmatch_votenextmap 1");
 
 		return -1.0f;
-	});
+	}, "mapvote/level_init");
 }
 
 void CMapVoteSystem::StartVote()
@@ -251,7 +251,7 @@ void CMapVoteSystem::StartVote()
 		CTimer::Create(6.0f, TIMERFLAG_MAP, []() {
 			g_pMapVoteSystem->FinishVote();
 			return -1.0f;
-		});
+		}, "mapvote/forced_next_map");
 
 		bAbort = true;
 	}
@@ -267,7 +267,7 @@ void CMapVoteSystem::StartVote()
 		CTimer::Create(6.0f, TIMERFLAG_MAP, []() {
 			g_pMapVoteSystem->GetCurrentMap()->Load();
 			return -1.0f;
-		});
+		}, "mapvote/reload_map");
 	}
 
 	if (bAbort)
@@ -345,7 +345,7 @@ void CMapVoteSystem::StartVote()
 	CTimer::Create(flVoteTime, TIMERFLAG_MAP, []() {
 		g_pMapVoteSystem->FinishVote();
 		return -1.0;
-	});
+	}, "mapvote/vote_end");
 }
 
 int CMapVoteSystem::GetTotalNominations(int iMapIndex)
@@ -428,7 +428,7 @@ void CMapVoteSystem::FinishVote()
 	CTimer::Create(1.0, TIMERFLAG_MAP, [pNextMap]() {
 		pNextMap->Load();
 		return -1.0f;
-	});
+	}, "mapvote/change_map");
 }
 
 bool CMapVoteSystem::RegisterPlayerVote(CPlayerSlot iPlayerSlot, int iVoteOption)
@@ -889,11 +889,11 @@ void CMapVoteSystem::OnMapDownloaded(DownloadItemResult_t* pResult)
 		PublishedFileId_t workshopID = m_DownloadQueue.front();
 		Message("Addon %llu download failed with status code 3, retrying in 2 minutes\n", workshopID);
 
-		m_pRateLimitedDownloadTimer = CTimer::Create(120.0f, TIMERFLAG_NONE, [workshopID]() {
+		m_hRateLimitedDownloadTimer = CTimer::Create(120.0f, TIMERFLAG_NONE, [workshopID]() {
 			g_steamAPI.SteamUGC()->DownloadItem(workshopID, false);
 
 			return -1.0f;
-		});
+		}, "mapvote/download_retry");
 
 		return;
 	}
@@ -984,14 +984,14 @@ bool CMapVoteSystem::LoadMapList()
 		}
 	}
 
-	m_pDownloadProgressTimer = CTimer::Create(0.f, TIMERFLAG_NONE, []() {
+	m_hDownloadProgressTimer = CTimer::Create(0.f, TIMERFLAG_NONE, []() {
 		if (g_pMapVoteSystem->GetDownloadQueueSize() == 0)
 			return -1.f;
 
 		g_pMapVoteSystem->PrintDownloadProgress();
 
 		return 1.f;
-	});
+	}, "mapvote/download_progress");
 
 	// Print all the maps
 	for (int i = 0; i < GetMapListSize(); i++)
@@ -1349,11 +1349,8 @@ bool CMapVoteSystem::ReloadMapList(bool bReloadMap)
 	{
 		m_DownloadQueue.clear();
 
-		if (!m_pDownloadProgressTimer.expired())
-			m_pDownloadProgressTimer.lock()->Cancel();
-
-		if (!m_pRateLimitedDownloadTimer.expired())
-			m_pRateLimitedDownloadTimer.lock()->Cancel();
+		m_hDownloadProgressTimer.Cancel();
+		m_hRateLimitedDownloadTimer.Cancel();
 	}
 
 	if (!g_pMapVoteSystem->LoadMapList())
@@ -19,6 +19,7 @@
 
 #include "KeyValues.h"
 #include "common.h"
+#include "ctimer.h"
 #include "entity/ccsplayercontroller.h"
 #include "steam/isteamugc.h"
 #include "steam/steam_api_common.h"
@@ -246,8 +247,8 @@ private:
 	int m_iVoteSize = 0;
 	bool g_bDisableCooldowns = false;
 	std::filesystem::file_time_type m_timeMapListModified = std::filesystem::file_time_type::min();
-	std::weak_ptr<CTimer> m_pDownloadProgressTimer;
-	std::weak_ptr<CTimer> m_pRateLimitedDownloadTimer;
+	CTimerHandle m_hDownloadProgressTimer;
+	CTimerHandle m_hRateLimitedDownloadTimer;
 	std::vector<std::shared_ptr<CWorkshopDetailsQuery>> m_vecWorkshopDetailsQueries;
 };
 
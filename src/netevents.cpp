@@ -0,0 +1,145 @@
+/**
+ * =============================================================================
+ * CS2Fixes
+ * Copyright (C) 2023-2025 Source2ZE
+ * =============================================================================
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License, version 3.0, as published by the
+ * Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "netevents.h"
+#include "ctimer.h"
+#include <algorithm>
+#include <bit>
+#include <vector>
+
+#include "tier0/memdbgon.h"
+
+CConVar<float> g_cvarNetEventStatsInterval("cs2f_netevent_stats_interval", FCVAR_NONE, "Seconds between logging and resetting network event stats, 0 to disable", 0.0f, true, 0.0f, false, 0.0f);
+
+struct NetEventStats_t
+{
+	INetworkMessageInternal* m_pEvent;
+	uint64 m_nPosts;
+	uint64 m_nBytes;
+	uint64 m_nRecipientsIn;
+	uint64 m_nRecipientsOut;
+	double m_flHandlerTime;
+};
+
+static NetEventStats_t g_netEventStats[MAX_POST_EVENT_MESSAGE_ID];
+
+// Plain pointers so the table is zero initialized before any handler registers during static init
+static CPostEventHandler* g_pPostEventHandlers[MAX_POST_EVENT_MESSAGE_ID];
+
+CPostEventHandler::CPostEventHandler(int nMessageId, FnPostEventHandler pfnHandler) :
+	m_pfnHandler(pfnHandler), m_pNext(nullptr)
+{
+	Assert(nMessageId >= 0 && nMessageId < MAX_POST_EVENT_MESSAGE_ID);
+
+	if (nMessageId < 0 || nMessageId >= MAX_POST_EVENT_MESSAGE_ID)
+		return;
+
+	CPostEventHandler** ppTail = &g_pPostEventHandlers[nMessageId];
+
+	while (*ppTail)
+		ppTail = &(*ppTail)->m_pNext;
+
+	*ppTail = this;
+}
+
+void DispatchPostEvent(int nMessageId, PostEventContext_t& context)
+{
+	if ((unsigned int)nMessageId >= MAX_POST_EVENT_MESSAGE_ID)
+		return;
+
+	NetEventStats_t& stats = g_netEventStats[nMessageId];
+	int nRecipients = context.pClients ? std::popcount(*context.pClients) : 0;
+
+	stats.m_pEvent = context.pEvent;
+	stats.m_nPosts++;
+	stats.m_nBytes += context.nSize;
+	stats.m_nRecipientsIn += nRecipients;
+
+	CPostEventHandler* pHandler = g_pPostEventHandlers[nMessageId];
+
+	if (!pHandler)
+	{
+		stats.m_nRecipientsOut += nRecipients;
+		return;
+	}
+
+	double flStart = Plat_FloatTime();
+
+	for (; pHandler; pHandler = pHandler->m_pNext)
+		pHandler->m_pfnHandler(context);
+
+	stats.m_flHandlerTime += Plat_FloatTime() - flStart;
+	stats.m_nRecipientsOut += context.pClients ? std::popcount(*context.pClients) : 0;
+}
+
+static void PrintNetEventStats(int iCount)
+{
+	std::vector<int> vecIds;
+
+	for (int i = 0; i < MAX_POST_EVENT_MESSAGE_ID; i++)
+		if (g_netEventStats[i].m_nPosts > 0)
+			vecIds.push_back(i);
+
+	std::sort(vecIds.begin(), vecIds.end(), [](int a, int b) { return g_netEventStats[a].m_nBytes > g_netEventStats[b].m_nBytes; });
+
+	Message("%-36s %5s %10s %12s %10s %10s %8s %12s\n", "Message", "Id", "Posts", "Bytes", "Recv in", "Recv out", "Saved", "Ours (ms)");
+
+	for (int i = 0; i < iCount && i < (int)vecIds.size(); i++)
+	{
+		NetEventStats_t& stats = g_netEventStats[vecIds[i]];
+		double flSaved = stats.m_nRecipientsIn ? 100.0 * (stats.m_nRecipientsIn - stats.m_nRecipientsOut) / stats.m_nRecipientsIn : 0.0;
+
+		Message("%-36s %5d %10llu %12llu %10llu %10llu %7.1f%% %12.3f\n", stats.m_pEvent->GetUnscopedName(), vecIds[i], stats.m_nPosts, stats.m_nBytes,
+				stats.m_nRecipientsIn, stats.m_nRecipientsOut, flSaved, stats.m_flHandlerTime * 1000.0);
+	}
+}
+
+static void ResetNetEventStats()
+{
+	V_memset(g_netEventStats, 0, sizeof(g_netEventStats));
+}
+
+void StartNetEventStatsDump()
+{
+	CTimer::Create(10.0f, TIMERFLAG_NONE, []() {
+		float flInterval = g_cvarNetEventStatsInterval.Get();
+
+		if (flInterval <= 0.0f)
+			return 10.0f;
+
+		Message("Network event stats for the last %.0f seconds:\n", flInterval);
+		PrintNetEventStats(MAX_POST_EVENT_MESSAGE_ID);
+		ResetNetEventStats();
+
+		return flInterval;
+	}, "netevents/stats");
+}
+
+CON_COMMAND_F(cs2f_netevent_stats, "<count|reset> - List outgoing network events by bytes sent, with recipients removed by our filters", FCVAR_SPONLY | FCVAR_LINKED_CONCOMMAND)
+{
+	if (args.ArgC() > 1 && !V_stricmp(args[1], "reset"))
+	{
+		ResetNetEventStats();
+		Message("Network event stats reset\n");
+		return;
+	}
+
+	PrintNetEventStats(args.ArgC() > 1 ? V_StringToInt32(args[1], 20) : 20);
+}
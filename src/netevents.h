@@ -0,0 +1,64 @@
+/**
+ * =============================================================================
+ * CS2Fixes
+ * Copyright (C) 2023-2025 Source2ZE
+ * =============================================================================
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License, version 3.0, as published by the
+ * Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include "common.h"
+#include "engine/igameeventsystem.h"
+#include "networksystem/inetworkserializer.h"
+
+// Message IDs are dense and small, anything past this can't have a handler
+#define MAX_POST_EVENT_MESSAGE_ID 1024
+
+// Arguments of an outgoing network event, handlers may edit the message in place and narrow pClients
+struct PostEventContext_t
+{
+	CSplitScreenSlot nSlot;
+	bool bLocalOnly;
+	int nClientCount;
+	uint64* pClients;
+	INetworkMessageInternal* pEvent;
+	const CNetMessage* pData;
+	unsigned long nSize;
+	NetChannelBufType_t bufType;
+};
+
+typedef void (*FnPostEventHandler)(PostEventContext_t& context);
+
+// Registers itself for a message ID on construction.
+// Handlers for the same ID run in an unspecified order (static init across files), so they must not depend on each other.
+// Instances are expected to have static storage duration, they form the handler chain themselves.
+class CPostEventHandler
+{
+public:
+	CPostEventHandler(int nMessageId, FnPostEventHandler pfnHandler);
+
+	FnPostEventHandler m_pfnHandler;
+	CPostEventHandler* m_pNext;
+};
+
+// Runs the handlers of a message ID and records its post count, size, recipients and time spent in handlers
+void DispatchPostEvent(int nMessageId, PostEventContext_t& context);
+void StartNetEventStatsDump();
+
+#define POST_EVENT_F(_id)                                                        \
+	static void _id##_PostEventHandler(PostEventContext_t&);                     \
+	static CPostEventHandler _id##_postEventHandler(_id, _id##_PostEventHandler); \
+	static void _id##_PostEventHandler(PostEventContext_t& context)
@@ -194,7 +194,7 @@ bool CPanoramaVoteHandler::SendYesNoVote(float flDuration, int iCaller, const ch
 		if (voteNum == g_pPanoramaVoteHandler->m_iVoteCount)
 			g_pPanoramaVoteHandler->EndVote(YesNoVoteEndReason::VoteEnd_TimeUp);
 		return -1.0;
-	});
+	}, "vote/end");
 
 	return true;
 }
@@ -254,9 +254,8 @@ void CPanoramaVoteHandler::CheckForEarlyVoteClose()
 	if (votes >= m_iVoterCount)
 	{
 		// Do this next frame to prevent a crash
-		CTimer::Create(0.0, TIMERFLAG_MAP, []() {
+		RunNextTick(TIMERFLAG_MAP, []() {
 			g_pPanoramaVoteHandler->EndVote(YesNoVoteEndReason::VoteEnd_AllVotes);
-			return -1.0;
 		});
 	}
 }
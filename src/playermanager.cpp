@@ -24,6 +24,7 @@
 #include "ctimer.h"
 #include "engine/igameeventsystem.h"
 #include "entity/ccsplayercontroller.h"
+#include "entity/ccsplayerpawn.h"
 #include "entwatch.h"
 #include "leader.h"
 #include "map_votes.h"
@@ -37,6 +38,8 @@
 #include "utlstring.h"
 #include "votemanager.h"
 #include <../cs2fixes.h>
+#include <algorithm>
+#include <bit>
 
 #include "tier0/memdbgon.h"
 
@@ -100,13 +103,12 @@ void ZEPlayer::OnSpawn()
 	SetSpeedMod(1.f);
 
 	ZEPlayerHandle handle = GetHandle();
-	CTimer::Create(0.0f, TIMERFLAG_MAP | TIMERFLAG_ROUND, [handle] {
+	RunNextTick(TIMERFLAG_MAP | TIMERFLAG_ROUND, [handle] {
 		if (handle.Get())
 		{
 			handle.Get()->CreatePointOrient();
 			handle.Get()->CreateEntwatchHud();
 		}
-		return -1.0f;
 	});
 }
 
@@ -117,6 +119,8 @@ void ZEPlayer::OnAuthenticated()
 
 	Message("%lli authenticated\n", GetSteamId64());
 
+	g_playerManager->SetPlayerAuthenticated(GetPlayerSlot().Get(), true);
+
 	CheckAdmin();
 	CheckInfractions();
 	g_pUserPreferencesSystem->PullPreferences(GetPlayerSlot().Get());
@@ -124,6 +128,18 @@ void ZEPlayer::OnAuthenticated()
 	SetSteamIdAttribute();
 }
 
+void ZEPlayer::SetInGame(bool bInGame)
+{
+	m_bInGame = bInGame;
+	g_playerManager->SetPlayerInGame(GetPlayerSlot().Get(), bInGame);
+}
+
+void ZEPlayer::SetLeader(bool bIsLeader)
+{
+	m_bIsLeader = bIsLeader;
+	g_playerManager->SetPlayerLeader(GetPlayerSlot().Get(), bIsLeader);
+}
+
 void ZEPlayer::CheckInfractions()
 {
 	g_pAdminSystem->ApplyInfractions(this);
@@ -153,13 +169,10 @@ bool ZEPlayer::IsAdminFlagSet(uint64 iFlag)
 	return !iFlag || (m_iAdminFlags & iFlag);
 }
 
-int ZEPlayer::GetHideDistance()
-{
-	return g_pUserPreferencesSystem->GetPreferenceInt(m_slot.Get(), HIDE_DISTANCE_PREF_KEY_NAME, 0);
-}
-
+// Cached since hide distances are read every tick, the preference stays the source of truth across sessions
 void ZEPlayer::SetHideDistance(int distance)
 {
+	m_iHideDistance = distance;
 	g_pUserPreferencesSystem->SetPreferenceInt(m_slot.Get(), HIDE_DISTANCE_PREF_KEY_NAME, distance);
 }
 
@@ -345,7 +358,7 @@ void ZEPlayer::StartBeacon(Color color, ZEPlayerHandle hGiver /* = 0*/)
 			if (particle)
 				particle->AcceptInput("DestroyImmediately");
 			return -1.0f;
-		});
+		}, "player/beacon_destroy");
 
 		if (!bLeaderBeacon)
 			return 1.0f;
@@ -364,7 +377,7 @@ void ZEPlayer::StartBeacon(Color color, ZEPlayerHandle hGiver /* = 0*/)
 		}
 
 		return 1.0f;
-	});
+	}, "player/beacon");
 }
 
 void ZEPlayer::EndBeacon()
@@ -501,7 +514,7 @@ void ZEPlayer::StartGlow(Color color, int duration)
 		}
 
 		return 0.5f;
-	});
+	}, "player/glow");
 
 	// kill glow after duration, if provided
 	if (duration < 1)
@@ -524,7 +537,7 @@ void ZEPlayer::StartGlow(Color color, int duration)
 			addresses::UTIL_Remove(pModelParent);
 
 		return -1.0f;
-	});
+	}, "player/glow_expire");
 }
 
 void ZEPlayer::EndGlow()
@@ -759,9 +772,85 @@ void ZEPlayer::SetEntwatchHudSize(float flSize)
 		pText->m_flFontSize = m_flEntwatchHudSize;
 }
 
+void CSteamIdSlotTable::Clear()
+{
+	V_memset(m_iSteamIds, 0, sizeof(m_iSteamIds));
+	V_memset(m_iSlots, -1, sizeof(m_iSlots));
+}
+
+void CSteamIdSlotTable::Insert(uint64 iSteamId, int iSlot)
+{
+	if (!iSteamId)
+		return;
+
+	// Can't fill up, there are 4 buckets per slot and each slot holds at most one entry
+	int i = GetHomeBucket(iSteamId);
+
+	while (m_iSteamIds[i])
+		i = (i + 1) & (TABLE_SIZE - 1);
+
+	m_iSteamIds[i] = iSteamId;
+	m_iSlots[i] = iSlot;
+}
+
+void CSteamIdSlotTable::Remove(uint64 iSteamId, int iSlot)
+{
+	if (!iSteamId)
+		return;
+
+	int i = GetHomeBucket(iSteamId);
+
+	while (m_iSteamIds[i] && (m_iSteamIds[i] != iSteamId || m_iSlots[i] != iSlot))
+		i = (i + 1) & (TABLE_SIZE - 1);
+
+	if (!m_iSteamIds[i])
+		return;
+
+	// Shift later entries of the probe run back into the hole, so lookups never need tombstones
+	for (int j = (i + 1) & (TABLE_SIZE - 1); m_iSteamIds[j]; j = (j + 1) & (TABLE_SIZE - 1))
+	{
+		int iHome = GetHomeBucket(m_iSteamIds[j]);
+
+		// Leave the entry be if its home bucket lies cyclically in (i, j]
+		if (i <= j ? (i < iHome && iHome <= j) : (i < iHome || iHome <= j))
+			continue;
+
+		m_iSteamIds[i] = m_iSteamIds[j];
+		m_iSlots[i] = m_iSlots[j];
+		i = j;
+	}
+
+	m_iSteamIds[i] = 0;
+	m_iSlots[i] = -1;
+}
+
+int CSteamIdSlotTable::GetSlots(uint64 iSteamId, int* pSlots) const
+{
+	int nSlots = 0;
+
+	if (!iSteamId)
+		return nSlots;
+
+	for (int i = GetHomeBucket(iSteamId); m_iSteamIds[i]; i = (i + 1) & (TABLE_SIZE - 1))
+	{
+		if (m_iSteamIds[i] == iSteamId)
+			pSlots[nSlots++] = m_iSlots[i];
+	}
+
+	return nSlots;
+}
+
 void CPlayerManager::OnBotConnected(CPlayerSlot slot)
 {
 	m_vecPlayers[slot.Get()] = new ZEPlayer(slot, true);
+
+	m_nConnectedMask |= (uint64)1 << slot.Get();
+	m_nBotMask |= (uint64)1 << slot.Get();
+}
+
+void CPlayerManager::OnHLTVConnected(CPlayerSlot slot)
+{
+	m_nHLTVMask |= (uint64)1 << slot.Get();
 }
 
 bool CPlayerManager::OnClientConnected(CPlayerSlot slot, uint64 xuid, const char* pszNetworkID)
@@ -800,6 +889,8 @@ bool CPlayerManager::OnClientConnected(CPlayerSlot slot, uint64 xuid, const char
 
 	pPlayer->SetConnected();
 	m_vecPlayers[slot.Get()] = pPlayer;
+	m_nConnectedMask |= (uint64)1 << slot.Get();
+	m_steamIdSlots.Insert(xuid, slot.Get());
 
 	ResetPlayerFlags(slot.Get());
 
@@ -819,9 +910,33 @@ void CPlayerManager::OnClientDisconnect(CPlayerSlot slot)
 	if (g_cvarEnableEntWatch.Get())
 		EW_PlayerDisconnect(slot.Get());
 
+	if (m_vecPlayers[slot.Get()] && !m_vecPlayers[slot.Get()]->IsFakeClient())
+		m_steamIdSlots.Remove(m_vecPlayers[slot.Get()]->GetUnauthenticatedSteamId64(), slot.Get());
+
 	delete m_vecPlayers[slot.Get()];
 	m_vecPlayers[slot.Get()] = nullptr;
 
+	uint64 iSlotMask = ~((uint64)1 << slot.Get());
+	m_nConnectedMask &= iSlotMask;
+	m_nInGameMask &= iSlotMask;
+	m_nAuthenticatedMask &= iSlotMask;
+	m_nAliveMask &= iSlotMask;
+	m_nBotMask &= iSlotMask;
+	m_nHLTVMask &= iSlotMask;
+	m_nLeaderMask &= iSlotMask;
+
+	for (uint64& nTeamMask : m_nTeamMask)
+		nTeamMask &= iSlotMask;
+
+	for (int iWeaponIndex : m_vecPlayerWeapons[slot.Get()])
+	{
+		m_trackedWeapons.Clear(iWeaponIndex);
+		SetEntityOwnerSlot(iWeaponIndex, -1);
+	}
+
+	m_vecPlayerWeapons[slot.Get()].clear();
+	SetPlayerPawn(slot.Get(), nullptr);
+
 	ResetPlayerFlags(slot.Get());
 
 	g_pMapVoteSystem->ClearPlayerInfo(slot.Get());
@@ -831,7 +946,7 @@ void CPlayerManager::OnClientDisconnect(CPlayerSlot slot)
 		g_pVoteManager->CheckRTVStatus();
 		g_pMapVoteSystem->ClearInvalidNominations();
 		return -1.0f;
-	});
+	}, "player/disconnect");
 
 	g_pPanoramaVoteHandler->RemovePlayerFromVote(slot.Get());
 }
@@ -866,7 +981,143 @@ void CPlayerManager::OnLateLoad()
 		if (!pController || !pController->IsController() || !pController->IsConnected())
 			continue;
 
+		// Same as a regular connect, SourceTV doesn't get a ZEPlayer
+		if (pController->m_bIsHLTV)
+		{
+			OnHLTVConnected(i);
+			continue;
+		}
+
 		OnClientConnected(i, pController->m_steamID(), "0.0.0.0:0");
+
+		if (pController->IsBot())
+			m_nBotMask |= (uint64)1 << i;
+
+		SetPlayerTeam(i, pController->m_iTeamNum);
+		SetPlayerAlive(i, pController->m_bPawnIsAlive());
+
+		CCSPlayerPawn* pPawn = pController->GetPlayerPawn();
+		SetPlayerPawn(i, pPawn);
+
+		if (!pPawn || !pPawn->m_pWeaponServices)
+			continue;
+
+		CUtlVector<CHandle<CBasePlayerWeapon>>* pWeapons = pPawn->m_pWeaponServices->m_hMyWeapons();
+
+		FOR_EACH_VEC(*pWeapons, j)
+		{
+			CBasePlayerWeapon* pWeapon = (*pWeapons)[j].Get();
+
+			if (pWeapon)
+				OnWeaponEquipped(pPawn, pWeapon);
+		}
+	}
+}
+
+void CPlayerManager::OnWeaponEquipped(CCSPlayerPawn* pPawn, CBasePlayerWeapon* pWeapon)
+{
+	CCSPlayerController* pController = pPawn ? pPawn->GetOriginalController() : nullptr;
+
+	if (!pController || !pWeapon)
+		return;
+
+	int iSlot = pController->GetPlayerSlot();
+	int iWeaponIndex = pWeapon->entindex();
+
+	if (iSlot < 0 || iSlot >= MAXPLAYERS || iWeaponIndex < 0 || iWeaponIndex >= MAX_TRACKED_ENTITIES)
+		return;
+
+	// Weapons can change hands without a drop, e.g. when taken straight from another player
+	UntrackWeapon(iWeaponIndex);
+
+	m_vecPlayerWeapons[iSlot].push_back(iWeaponIndex);
+	m_trackedWeapons.Set(iWeaponIndex);
+	SetEntityOwnerSlot(iWeaponIndex, iSlot);
+}
+
+void CPlayerManager::OnWeaponDropped(CBasePlayerWeapon* pWeapon)
+{
+	if (pWeapon)
+		UntrackWeapon(pWeapon->entindex());
+}
+
+void CPlayerManager::OnEntityDeleted(CEntityInstance* pEntity)
+{
+	int iIndex = pEntity->entindex();
+
+	// Keep the snapshot from handing out freed entities for the rest of the frame
+	for (int i = 0; i < m_snapshot.m_iMaxClients; i++)
+	{
+		if (m_snapshot.m_pController[i] == pEntity)
+			m_snapshot.m_pController[i] = nullptr;
+
+		if (m_snapshot.m_pPawn[i] == pEntity)
+		{
+			m_snapshot.m_pPawn[i] = nullptr;
+			m_snapshot.m_nAliveMask &= ~((uint64)1 << i);
+		}
+
+		if (m_snapshot.m_pPlayerPawn[i] == pEntity)
+			m_snapshot.m_pPlayerPawn[i] = nullptr;
+	}
+
+	UntrackWeapon(iIndex);
+
+	int iOwnerSlot = GetEntityOwnerSlot(iIndex);
+
+	if (iOwnerSlot == -1)
+		return;
+
+	if (m_iPawnIndex[iOwnerSlot] == iIndex)
+	{
+		m_iPawnIndex[iOwnerSlot] = -1;
+		SetPlayerAlive(iOwnerSlot, false);
+	}
+
+	SetEntityOwnerSlot(iIndex, -1);
+}
+
+void CPlayerManager::OnEntityParentChanged(CEntityInstance* pEntity, CEntityInstance* pNewParent)
+{
+	// Held weapons are parented to their pawn, losing the parent means it left the player without going through DropWeapon
+	if (!pNewParent)
+		UntrackWeapon(pEntity->entindex());
+}
+
+void CPlayerManager::SetPlayerPawn(int slot, CCSPlayerPawn* pPawn)
+{
+	int iOldIndex = m_iPawnIndex[slot];
+
+	if (iOldIndex != -1 && GetEntityOwnerSlot(iOldIndex) == slot)
+		SetEntityOwnerSlot(iOldIndex, -1);
+
+	m_iPawnIndex[slot] = pPawn ? pPawn->entindex() : -1;
+
+	if (pPawn)
+		SetEntityOwnerSlot(pPawn->entindex(), slot);
+}
+
+void CPlayerManager::UntrackWeapon(int iWeaponIndex)
+{
+	// Non-networked entities are indexed past the tracked range and can never be held weapons
+	if (iWeaponIndex < 0 || iWeaponIndex >= MAX_TRACKED_ENTITIES)
+		return;
+
+	if (!m_trackedWeapons.Get(iWeaponIndex))
+		return;
+
+	m_trackedWeapons.Clear(iWeaponIndex);
+	SetEntityOwnerSlot(iWeaponIndex, -1);
+
+	for (int i = 0; i < MAXPLAYERS; i++)
+	{
+		auto it = std::find(m_vecPlayerWeapons[i].begin(), m_vecPlayerWeapons[i].end(), iWeaponIndex);
+
+		if (it != m_vecPlayerWeapons[i].end())
+		{
+			m_vecPlayerWeapons[i].erase(it);
+			return;
+		}
 	}
 }
 
@@ -883,10 +1134,13 @@ void CPlayerManager::OnValidateAuthTicket(ValidateAuthTicketResponse_t* pRespons
 
 	Message("%s: SteamID=%llu Response=%d\n", __func__, iSteamId, pResponse->m_eAuthSessionResponse);
 
-	ZEPlayer* pPlayer = nullptr;
+	int iSlots[MAXPLAYERS];
+	int nSlots = m_steamIdSlots.GetSlots(iSteamId, iSlots);
 
-	for (ZEPlayer* pPlayer : m_vecPlayers)
+	for (int i = 0; i < nSlots; i++)
 	{
+		ZEPlayer* pPlayer = m_vecPlayers[iSlots[i]];
+
 		if (!pPlayer || pPlayer->IsFakeClient() || !(pPlayer->GetUnauthenticatedSteamId64() == iSteamId))
 			continue;
 
@@ -925,102 +1179,149 @@ void CPlayerManager::OnValidateAuthTicket(ValidateAuthTicketResponse_t* pRespons
 
 					g_pEngineServer2->DisconnectClient(hPlayer.GetPlayerSlot(), NETWORK_DISCONNECT_KICKED_NOSTEAMLOGIN, "Auto kicked for failed steam authentication");
 					return -1.f;
-				});
+				}, "player/auth_kick");
 			}
 		}
 	}
 }
 
-void CPlayerManager::CheckInfractions()
+void CPlayerManager::CheckInfractions(int iSlot)
 {
-	if (!GetGlobals())
+	if (m_vecPlayers[iSlot] == nullptr || m_vecPlayers[iSlot]->IsFakeClient())
 		return;
 
-	for (int i = 0; i < GetGlobals()->maxClients; i++)
-	{
-		if (m_vecPlayers[i] == nullptr || m_vecPlayers[i]->IsFakeClient())
-			continue;
-
-		m_vecPlayers[i]->CheckInfractions();
-	}
-
-	g_pAdminSystem->SaveInfractions();
+	m_vecPlayers[iSlot]->CheckInfractions();
 }
 
 CConVar<bool> g_cvarFlashLightEnable("cs2f_flashlight_enable", FCVAR_NONE, "Whether to enable flashlights", false);
 
 void CPlayerManager::FlashLightThink()
 {
-	if (!g_cvarFlashLightEnable.Get() || !GetGlobals())
+	if (!g_cvarFlashLightEnable.Get())
 		return;
 
 	VPROF("CPlayerManager::FlashLightThink");
 
-	for (int i = 0; i < GetGlobals()->maxClients; i++)
+	const PlayerSnapshot_t& snapshot = m_snapshot;
+
+	for (int i = 0; i < snapshot.m_iMaxClients; i++)
 	{
-		CCSPlayerController* pPlayer = CCSPlayerController::FromSlot(i);
+		ZEPlayer* pPlayer = m_vecPlayers[i];
 
-		if (!pPlayer || !pPlayer->m_bPawnIsAlive())
+		// Check both to make sure flashlight is only toggled when the player presses the key
+		if (!pPlayer || !snapshot.IsAlive(i) || !(snapshot.m_nButtons[i] & snapshot.m_nButtonsChanged[i] & IN_LOOK_AT_WEAPON))
 			continue;
 
-		uint64* pButtons = pPlayer->GetPawn()->m_pMovementServices->m_nButtons().m_pButtonStates();
-
-		// Check both to make sure flashlight is only toggled when the player presses the key
-		if ((pButtons[0] & IN_LOOK_AT_WEAPON) && (pButtons[1] & IN_LOOK_AT_WEAPON))
-			pPlayer->GetZEPlayer()->ToggleFlashLight();
+		pPlayer->ToggleFlashLight();
 	}
 }
 
 CConVar<bool> g_cvarHideTeammatesOnly("cs2f_hide_teammates_only", FCVAR_NONE, "Whether to hide teammates only", false);
 
-void CPlayerManager::CheckHideDistances()
+void CPlayerManager::UpdateSnapshot()
 {
+	VPROF("CPlayerManager::UpdateSnapshot");
+
+	PlayerSnapshot_t& snapshot = m_snapshot;
+	V_memset(&snapshot, 0, sizeof(snapshot));
+
+	snapshot.m_nTick = g_nUniversalTick;
+
 	if (!g_pEntitySystem || !GetGlobals())
 		return;
 
-	VPROF("CPlayerManager::CheckHideDistances");
+	snapshot.m_iMaxClients = MIN(GetGlobals()->maxClients, MAXPLAYERS);
 
-	for (int i = 0; i < GetGlobals()->maxClients; i++)
+	for (int i = 0; i < snapshot.m_iMaxClients; i++)
 	{
-		auto player = GetPlayer(i);
+		CCSPlayerController* pController = CCSPlayerController::FromSlot(i);
 
-		if (!player)
+		if (!pController)
 			continue;
 
-		player->ClearTransmit();
-		auto hideDistance = player->GetHideDistance();
+		uint64 nBit = (uint64)1 << i;
+		int iTeam = pController->m_iTeamNum;
+
+		snapshot.m_pController[i] = pController;
+		snapshot.m_iTeam[i] = iTeam;
+		snapshot.m_nTeamMask[iTeam & 3] |= nBit;
+
+		if (pController->IsConnected())
+			snapshot.m_nConnectedMask |= nBit;
+
+		if (pController->m_bIsHLTV)
+			snapshot.m_nHLTVMask |= nBit;
 
-		if (!hideDistance)
+		CBasePlayerPawn* pPawn = pController->GetPawn();
+
+		snapshot.m_pPawn[i] = pPawn;
+		snapshot.m_pPlayerPawn[i] = pController->GetPlayerPawn();
+
+		if (!pPawn)
 			continue;
 
-		CCSPlayerController* pController = CCSPlayerController::FromSlot(i);
+		if (pPawn->m_pMovementServices)
+		{
+			uint64* pButtons = pPawn->m_pMovementServices->m_nButtons().m_pButtonStates();
+			snapshot.m_nButtons[i] = pButtons[0];
+			snapshot.m_nButtonsChanged[i] = pButtons[1];
+		}
 
-		if (!pController)
+		if (!pPawn->IsAlive())
+			continue;
+
+		const Vector& vecOrigin = pPawn->GetAbsOrigin();
+		snapshot.m_flOriginX[i] = vecOrigin.x;
+		snapshot.m_flOriginY[i] = vecOrigin.y;
+		snapshot.m_flOriginZ[i] = vecOrigin.z;
+		snapshot.m_nAliveMask |= nBit;
+	}
+}
+
+void CPlayerManager::CheckHideDistances()
+{
+	VPROF("CPlayerManager::CheckHideDistances");
+
+	// Each viewer is a single branchless pass over the snapshot's origin arrays, with at most 64 players that beats any spatial partitioning
+	const PlayerSnapshot_t& snapshot = m_snapshot;
+	bool bTeammatesOnly = g_cvarHideTeammatesOnly.Get();
+
+	for (int i = 0; i < snapshot.m_iMaxClients; i++)
+	{
+		ZEPlayer* pPlayer = m_vecPlayers[i];
+
+		if (!pPlayer)
 			continue;
 
-		auto pPawn = pController->GetPawn();
+		int iHideDistance = pPlayer->GetHideDistance();
 
-		if (!pPawn || !pPawn->IsAlive())
+		// Dead viewers and viewers without hide see everyone
+		if (!iHideDistance || !snapshot.IsAlive(i))
+		{
+			pPlayer->SetHiddenPlayersMask(0);
 			continue;
+		}
 
-		auto vecPosition = pPawn->GetAbsOrigin();
-		int team = pController->m_iTeamNum;
+		float flX = snapshot.m_flOriginX[i];
+		float flY = snapshot.m_flOriginY[i];
+		float flZ = snapshot.m_flOriginZ[i];
+		float flMaxDistSqr = (float)iHideDistance * (float)iHideDistance;
 
-		for (int j = 0; j < GetGlobals()->maxClients; j++)
+		uint64 nInRange = 0;
+		for (int j = 0; j < snapshot.m_iMaxClients; j++)
 		{
-			if (j == i)
-				continue;
+			float dx = snapshot.m_flOriginX[j] - flX;
+			float dy = snapshot.m_flOriginY[j] - flY;
+			float dz = snapshot.m_flOriginZ[j] - flZ;
+			nInRange |= (uint64)(dx * dx + dy * dy + dz * dz <= flMaxDistSqr) << j;
+		}
 
-			CCSPlayerController* pTargetController = CCSPlayerController::FromSlot(j);
+		nInRange &= snapshot.m_nAliveMask & ~((uint64)1 << i);
 
-			if (pTargetController)
-			{
-				auto pTargetPawn = pTargetController->GetPawn();
+		if (bTeammatesOnly)
+			nInRange &= snapshot.m_nTeamMask[snapshot.m_iTeam[i] & 3];
 
-				if (pTargetPawn && pTargetPawn->IsAlive() && (!g_cvarHideTeammatesOnly.Get() || pTargetController->m_iTeamNum == team))
-					player->SetTransmit(j, pTargetPawn->GetAbsOrigin().DistToSqr(vecPosition) <= hideDistance * hideDistance);
-			}
-		}
+		pPlayer->SetHiddenPlayersMask(nInRange);
 	}
 }
 
@@ -1038,17 +1339,16 @@ static const char* g_szPlayerStates[] =
 
 void CPlayerManager::UpdatePlayerStates()
 {
-	if (!GetGlobals())
-		return;
+	const PlayerSnapshot_t& snapshot = m_snapshot;
 
-	for (int i = 0; i < GetGlobals()->maxClients; i++)
+	for (int i = 0; i < snapshot.m_iMaxClients; i++)
 	{
-		ZEPlayer* pPlayer = GetPlayer(i);
+		ZEPlayer* pPlayer = m_vecPlayers[i];
 
 		if (!pPlayer)
 			continue;
 
-		CCSPlayerController* pController = CCSPlayerController::FromSlot(i);
+		CCSPlayerController* pController = snapshot.m_pController[i];
 
 		if (!pController)
 			continue;
@@ -1068,7 +1368,7 @@ void CPlayerManager::UpdatePlayerStates()
 		// Update entwatch hud position
 		if (g_cvarEnableEntWatch.Get() && g_cvarEnableEntwatchHud.Get())
 		{
-			CCSPlayerPawn* pPawn = pController->GetPlayerPawn();
+			CCSPlayerPawn* pPawn = snapshot.m_pPlayerPawn[i];
 			if (!pPawn)
 				continue;
 
@@ -1086,29 +1386,27 @@ CConVar<bool> g_cvarInfiniteAmmo("cs2f_infinite_reserve_ammo", FCVAR_NONE, "Whet
 
 void CPlayerManager::SetupInfiniteAmmo()
 {
-	CTimer::Create(5.0f, TIMERFLAG_MAP, []() {
-		if (!g_cvarInfiniteAmmo.Get() || !GetGlobals())
-			return 5.0f;
+	CTimer::CreatePlayerSweep(
+		INFINITE_AMMO_TICKS, GetTicksUntilPhase(INFINITE_AMMO_TICKS, INFINITE_AMMO_PHASE), TIMERFLAG_MAP,
+		[]() { return g_cvarInfiniteAmmo.Get() && GetGlobals(); },
+		[](int iSlot) {
+			VPROF("CPlayerManager::InfiniteAmmoTimer");
 
-		VPROF("CPlayerManager::InfiniteAmmoTimer");
-
-		for (int i = 0; i < GetGlobals()->maxClients; i++)
-		{
-			CCSPlayerController* pController = CCSPlayerController::FromSlot(i);
+			CCSPlayerController* pController = CCSPlayerController::FromSlot(iSlot);
 
 			if (!pController)
-				continue;
+				return;
 
 			auto pPawn = pController->GetPawn();
 
 			if (!pPawn)
-				continue;
+				return;
 
 			CCSPlayer_WeaponServices* pWeaponServices = pPawn->m_pWeaponServices;
 
 			// it can sometimes be null when player joined on the very first round?
 			if (!pWeaponServices)
-				continue;
+				return;
 
 			CUtlVector<CHandle<CBasePlayerWeapon>>* weapons = pWeaponServices->m_hMyWeapons();
 
@@ -1122,10 +1420,8 @@ void CPlayerManager::SetupInfiniteAmmo()
 				if (weapon->GetWeaponVData()->m_GearSlot() == GEAR_SLOT_RIFLE || weapon->GetWeaponVData()->m_GearSlot() == GEAR_SLOT_PISTOL)
 					weapon->AcceptInput("SetReserveAmmoAmount", "999"); // 999 will be automatically clamped to the weapons m_nPrimaryReserveAmmoMax
 			}
-		}
-
-		return 5.0f;
-	});
+		},
+		[]() {}, "player/infinite_ammo");
 }
 
 // Returns ETargetError::NO_ERRORS if pPlayer can target pTarget given iBlockedFlags and iOnlyThisTeam
@@ -1731,9 +2027,16 @@ ZEPlayer* CPlayerManager::GetPlayerFromUserId(uint16 userid)
 
 ZEPlayer* CPlayerManager::GetPlayerFromSteamId(uint64 steamid)
 {
-	for (ZEPlayer* player : m_vecPlayers)
+	int iSlots[MAXPLAYERS];
+	int nSlots = m_steamIdSlots.GetSlots(steamid, iSlots);
+
+	for (int i = 0; i < nSlots; i++)
+	{
+		ZEPlayer* player = m_vecPlayers[iSlots[i]];
+
 		if (player && player->IsAuthenticated() && player->GetSteamId64() == steamid)
 			return player;
+	}
 
 	return nullptr;
 }
@@ -1829,20 +2132,51 @@ void CPlayerManager::ResetPlayerFlags(int slot)
 	SetPlayerNoShake(slot, false);
 }
 
-int CPlayerManager::GetOnlinePlayerCount(bool bCountBots)
+void CPlayerManager::SetPlayerInGame(int slot, bool set)
 {
-	int iOnlinePlayers = 0;
+	if (set)
+		m_nInGameMask |= ((uint64)1 << slot);
+	else
+		m_nInGameMask &= ~((uint64)1 << slot);
+}
 
-	if (!GetClientList())
-		return iOnlinePlayers;
+void CPlayerManager::SetPlayerAuthenticated(int slot, bool set)
+{
+	if (set)
+		m_nAuthenticatedMask |= ((uint64)1 << slot);
+	else
+		m_nAuthenticatedMask &= ~((uint64)1 << slot);
+}
 
-	for (int i = 0; i < GetClientList()->Count(); i++)
-	{
-		CServerSideClient* pClient = (*GetClientList())[i];
+void CPlayerManager::SetPlayerAlive(int slot, bool set)
+{
+	if (set)
+		m_nAliveMask |= ((uint64)1 << slot);
+	else
+		m_nAliveMask &= ~((uint64)1 << slot);
+}
 
-		if (pClient && pClient->GetSignonState() >= SIGNONSTATE_CONNECTED && (bCountBots || !pClient->IsFakeClient()))
-			iOnlinePlayers++;
-	}
+void CPlayerManager::SetPlayerTeam(int slot, int iTeam)
+{
+	for (uint64& nTeamMask : m_nTeamMask)
+		nTeamMask &= ~((uint64)1 << slot);
+
+	m_nTeamMask[iTeam & 3] |= ((uint64)1 << slot);
 
-	return iOnlinePlayers;
+	// Spectators and unassigned players have no pawn to be alive with
+	if (iTeam < CS_TEAM_T)
+		SetPlayerAlive(slot, false);
+}
+
+void CPlayerManager::SetPlayerLeader(int slot, bool set)
+{
+	if (set)
+		m_nLeaderMask |= ((uint64)1 << slot);
+	else
+		m_nLeaderMask &= ~((uint64)1 << slot);
+}
+
+int CPlayerManager::GetOnlinePlayerCount(bool bCountBots)
+{
+	return std::popcount(bCountBots ? m_nConnectedMask | m_nHLTVMask : m_nConnectedMask & ~m_nBotMask);
 }
\ No newline at end of file
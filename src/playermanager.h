@@ -30,6 +30,7 @@
 #include "steam/steamclientpublic.h"
 #include "utlvector.h"
 #include <playerslot.h>
+#include <vector>
 
 extern CConVar<bool> g_cvarFlashLightTransmitOthers;
 extern CConVar<CUtlString> g_cvarFlashLightAttachment;
@@ -56,6 +57,15 @@ extern CConVar<CUtlString> g_cvarFlashLightAttachment;
 #define ZSOUNDS_PREF_KEY_NAME "zsounds"
 #define INVALID_ZEPLAYERHANDLE_INDEX 0u
 
+// Intervals and phases of the periodic player checks, see GetTicksUntilPhase
+#define INFINITE_AMMO_TICKS 320
+#define INFINITE_AMMO_PHASE 8
+#define INFRACTION_CHECK_TICKS 1920
+#define INFRACTION_CHECK_PHASE 4
+
+// Entity indices covered by the per-entity player tables
+#define MAX_TRACKED_ENTITIES 16384
+
 static uint32 iZEPlayerHandleSerial = 0u; // this should actually be 3 bytes large, but no way enough players join in servers lifespan for this to be an issue
 
 enum class ETargetType
@@ -108,6 +118,10 @@ enum class ETargetError
 };
 
 class ZEPlayer;
+class CCSPlayerController;
+class CBasePlayerPawn;
+class CCSPlayerPawn;
+class CBasePlayerWeapon;
 struct ZRClass;
 struct ZRModelEntry;
 
@@ -162,6 +176,7 @@ public:
 		m_bMuted = false;
 		m_bEbanned = false;
 		m_iHideDistance = 0;
+		m_nHiddenPlayersMask = 0;
 		m_bConnected = false;
 		m_iTotalDamage = 0;
 		m_iTotalHits = 0;
@@ -226,8 +241,7 @@ public:
 	void SetMuted(bool muted) { m_bMuted = muted; }
 	void SetGagged(bool gagged) { m_bGagged = gagged; }
 	void SetEbanned(bool ebanned) { m_bEbanned = ebanned; }
-	void SetTransmit(int index, bool shouldTransmit) { shouldTransmit ? m_shouldTransmit.Set(index) : m_shouldTransmit.Clear(index); }
-	void ClearTransmit() { m_shouldTransmit.ClearAll(); }
+	void SetHiddenPlayersMask(uint64 mask) { m_nHiddenPlayersMask = mask; }
 	void SetHideDistance(int distance);
 	void SetTotalDamage(int damage) { m_iTotalDamage = damage; }
 	void SetTotalHits(int hits) { m_iTotalHits = hits; }
@@ -238,13 +252,13 @@ public:
 	void SetInfectState(bool bInfectState) { m_bIsInfected = bInfectState; }
 	void SetExtendVoteTime(float flCurtime) { m_flExtendVoteTime = flCurtime; }
 	void SetIpAddress(std::string strIp) { m_strIp = strIp; }
-	void SetInGame(bool bInGame) { m_bInGame = bInGame; }
+	void SetInGame(bool bInGame);
 	void SetImmunity(int iMZImmunity) { m_iMZImmunity = iMZImmunity; }
 	void SetNominateTime(float flCurtime) { m_flNominateTime = flCurtime; }
 	void SetFlashLight(CBarnLight* pLight) { m_hFlashLight.Set(pLight); }
 	void SetBeaconParticle(CParticleSystem* pParticle) { m_hBeaconParticle.Set(pParticle); }
 	void SetPlayerState(uint32 iPlayerState) { m_iPlayerState = iPlayerState; }
-	void SetLeader(bool bIsLeader) { m_bIsLeader = bIsLeader; }
+	void SetLeader(bool bIsLeader);
 	void CreateMark(float fDuration, Vector vecOrigin);
 	void SetLeaderColor(Color colorLeader) { m_colorLeader = colorLeader; }
 	void SetTracerColor(Color colorTracer) { m_colorTracer = colorTracer; }
@@ -273,8 +287,9 @@ public:
 	bool IsMuted() { return m_bMuted; }
 	bool IsGagged() { return m_bGagged; }
 	bool IsEbanned() { return m_bEbanned; }
-	bool ShouldBlockTransmit(int index) { return m_shouldTransmit.Get(index); }
-	int GetHideDistance();
+	bool ShouldBlockTransmit(int index) { return m_nHiddenPlayersMask & ((uint64)1 << index); }
+	uint64 GetHiddenPlayersMask() { return m_nHiddenPlayersMask; }
+	int GetHideDistance() { return m_iHideDistance; }
 	CPlayerSlot GetPlayerSlot() { return m_slot; }
 	int GetTotalDamage() { return m_iTotalDamage; }
 	int GetTotalHits() { return m_iTotalHits; }
@@ -346,7 +361,7 @@ private:
 	uint64 m_iAdminFlags;
 	int m_iAdminImmunity;
 	int m_iHideDistance;
-	CBitVec<MAXPLAYERS> m_shouldTransmit;
+	uint64 m_nHiddenPlayersMask; // Players within hide distance, recomputed every tick
 	int m_iTotalDamage;
 	int m_iTotalHits;
 	int m_iTotalKills;
@@ -391,6 +406,59 @@ private:
 	float m_flEntwatchHudSize;
 };
 
+// Open addressed SteamID64 -> player slot lookup, with linear probing and backward shift removal.
+// Sized to stay at most a quarter full, the same SteamID can be held by several slots while unauthenticated.
+class CSteamIdSlotTable
+{
+public:
+	CSteamIdSlotTable() { Clear(); }
+
+	void Clear();
+	void Insert(uint64 iSteamId, int iSlot);
+	void Remove(uint64 iSteamId, int iSlot);
+
+	// Fills pSlots with every slot registered under the SteamID, returns how many
+	int GetSlots(uint64 iSteamId, int* pSlots) const;
+
+private:
+	static constexpr int TABLE_SIZE = MAXPLAYERS * 4;
+	static_assert((TABLE_SIZE & (TABLE_SIZE - 1)) == 0, "TABLE_SIZE must be a power of two");
+
+	static int GetHomeBucket(uint64 iSteamId) { return (int)(((uint32)iSteamId * 2654435761u) >> 24) & (TABLE_SIZE - 1); }
+
+	// 0 marks an empty bucket, which is fine as no real SteamID is 0
+	uint64 m_iSteamIds[TABLE_SIZE];
+	int8 m_iSlots[TABLE_SIZE];
+};
+
+// Every player slot as of the start of the current frame, so per-frame systems read plain arrays instead of going through schema accessors.
+// Pointers are cleared when their entity is deleted, origins and buttons are only updated once per frame.
+struct PlayerSnapshot_t
+{
+	uint64 m_nTick;
+	int m_iMaxClients;
+
+	uint64 m_nConnectedMask;
+	uint64 m_nAliveMask;
+	uint64 m_nHLTVMask;
+	uint64 m_nTeamMask[4];
+
+	CCSPlayerController* m_pController[MAXPLAYERS];
+	CBasePlayerPawn* m_pPawn[MAXPLAYERS];	  // Current pawn, which is the observer pawn while spectating
+	CCSPlayerPawn* m_pPlayerPawn[MAXPLAYERS]; // Actual player pawn, even while spectating
+	int m_iTeam[MAXPLAYERS];
+	uint64 m_nButtons[MAXPLAYERS];		  // Buttons held, from the current pawn
+	uint64 m_nButtonsChanged[MAXPLAYERS]; // Buttons that changed this tick
+
+	// Alive pawn origins, zero for everyone else
+	alignas(32) float m_flOriginX[MAXPLAYERS];
+	alignas(32) float m_flOriginY[MAXPLAYERS];
+	alignas(32) float m_flOriginZ[MAXPLAYERS];
+
+	bool IsConnected(int slot) const { return m_nConnectedMask & ((uint64)1 << slot); }
+	bool IsAlive(int slot) const { return m_nAliveMask & ((uint64)1 << slot); }
+};
+
 class CPlayerManager
 {
 public:
@@ -402,17 +470,38 @@ public:
 		m_nUsingZSounds = -1; // On by default
 		m_nUsingStopDecals = -1; // On by default
 		m_nUsingNoShake = 0;
+		m_nConnectedMask = 0;
+		m_nInGameMask = 0;
+		m_nAuthenticatedMask = 0;
+		m_nAliveMask = 0;
+		m_nBotMask = 0;
+		m_nHLTVMask = 0;
+		m_nLeaderMask = 0;
+		V_memset(m_nTeamMask, 0, sizeof(m_nTeamMask));
+		V_memset(m_iEntityOwnerSlot, -1, sizeof(m_iEntityOwnerSlot));
+		V_memset(m_iPawnIndex, -1, sizeof(m_iPawnIndex));
+		V_memset(&m_snapshot, 0, sizeof(m_snapshot));
 	}
 
 	bool OnClientConnected(CPlayerSlot slot, uint64 xuid, const char* pszNetworkID);
 	void OnClientDisconnect(CPlayerSlot slot);
 	void OnBotConnected(CPlayerSlot slot);
+	void OnHLTVConnected(CPlayerSlot slot);
 	void OnClientPutInServer(CPlayerSlot slot);
 	void OnLateLoad();
 	void OnSteamAPIActivated();
-	void CheckInfractions();
+	void CheckInfractions(int iSlot);
 	void FlashLightThink();
+	void UpdateSnapshot();
+	const PlayerSnapshot_t& GetSnapshot() { return m_snapshot; }
 	void CheckHideDistances();
+	void OnWeaponEquipped(CCSPlayerPawn* pPawn, CBasePlayerWeapon* pWeapon);
+	void OnWeaponDropped(CBasePlayerWeapon* pWeapon);
+	void OnEntityDeleted(CEntityInstance* pEntity);
+	void OnEntityParentChanged(CEntityInstance* pEntity, CEntityInstance* pNewParent);
+	const std::vector<int>& GetPlayerWeapons(int slot) { return m_vecPlayerWeapons[slot]; }
+	void SetPlayerPawn(int slot, CCSPlayerPawn* pPawn);
+	int GetEntityOwnerSlot(int index) { return index >= 0 && index < MAX_TRACKED_ENTITIES ? m_iEntityOwnerSlot[index] : -1; }
 	void SetupInfiniteAmmo();
 	CPlayerSlot GetSlotFromUserId(uint16 userid);
 	ZEPlayer* GetPlayerFromUserId(uint16 userid);
@@ -445,19 +534,63 @@ public:
 	bool IsPlayerUsingStopDecals(int slot) { return m_nUsingStopDecals & ((uint64)1 << slot); }
 	bool IsPlayerUsingNoShake(int slot) { return m_nUsingNoShake & ((uint64)1 << slot); }
 
+	uint64 GetConnectedMask() { return m_nConnectedMask; }
+	uint64 GetInGameMask() { return m_nInGameMask; }
+	uint64 GetAuthenticatedMask() { return m_nAuthenticatedMask; }
+	uint64 GetAliveMask() { return m_nAliveMask; }
+	uint64 GetTeamMask(int iTeam) { return m_nTeamMask[iTeam & 3]; }
+	uint64 GetBotMask() { return m_nBotMask; }
+	uint64 GetLeaderMask() { return m_nLeaderMask; }
+
+	void SetPlayerInGame(int slot, bool set);
+	void SetPlayerAuthenticated(int slot, bool set);
+	void SetPlayerAlive(int slot, bool set);
+	void SetPlayerTeam(int slot, int iTeam);
+	void SetPlayerLeader(int slot, bool set);
+
 	void UpdatePlayerStates();
 	int GetOnlinePlayerCount(bool bCountBots);
 
 	STEAM_GAMESERVER_CALLBACK_MANUAL(CPlayerManager, OnValidateAuthTicket, ValidateAuthTicketResponse_t, m_CallbackValidateAuthTicketResponse);
 
 private:
+	void UntrackWeapon(int iWeaponIndex);
+	void SetEntityOwnerSlot(int index, int slot)
+	{
+		if (index >= 0 && index < MAX_TRACKED_ENTITIES)
+			m_iEntityOwnerSlot[index] = slot;
+	}
+
 	ZEPlayer* m_vecPlayers[MAXPLAYERS];
 
+	// Entity indices of the weapons each player is holding, so per-tick code doesn't have to resolve m_hMyWeapons handles
+	std::vector<int> m_vecPlayerWeapons[MAXPLAYERS];
+	CBitVec<MAX_TRACKED_ENTITIES> m_trackedWeapons;
+
+	PlayerSnapshot_t m_snapshot;
+
+	// Keyed by the unauthenticated SteamID from connect, which is what gets authenticated later
+	CSteamIdSlotTable m_steamIdSlots;
+
+	// Slot of the player each pawn and held weapon belongs to, -1 for everything else
+	int8 m_iEntityOwnerSlot[MAX_TRACKED_ENTITIES];
+	int m_iPawnIndex[MAXPLAYERS];
+
 	uint64 m_nUsingStopSound;
 	uint64 m_nUsingSilenceSound;
 	uint64 m_nUsingZSounds;
 	uint64 m_nUsingStopDecals;
 	uint64 m_nUsingNoShake;
+
+	// Player states kept up to date from connect/disconnect and game events, so counting or filtering players is a popcount or a bitwise op
+	uint64 m_nConnectedMask;
+	uint64 m_nInGameMask;
+	uint64 m_nAuthenticatedMask;
+	uint64 m_nAliveMask;
+	uint64 m_nTeamMask[4];
+	uint64 m_nBotMask;
+	uint64 m_nHLTVMask; // SourceTV has no ZEPlayer and isn't in any other mask
+	uint64 m_nLeaderMask;
 };
 
 extern CPlayerManager* g_playerManager;
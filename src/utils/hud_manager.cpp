@@ -84,7 +84,7 @@ void CreateHudMessage(std::shared_ptr<CHudMessage> pHudMessage)
 		g_vecHudMessages.erase(std::remove(g_vecHudMessages.begin(), g_vecHudMessages.end(), pHudMessage), g_vecHudMessages.end());
 
 		return -1.0f;
-	});
+	}, "hud/expire");
 
 	g_gameEventManager->SerializeEvent(pEvent, data);
 	g_gameEventSystem->PostEventAbstract(-1, false, &filter, pMsg, data, 0);
@@ -147,7 +147,7 @@ void StartFlashingFixTimer()
 			g_pGameRules->m_bGameRestart = false;
 
 		return 0.5f;
-	});
+	}, "hud/flashing_fix");
 }
 
 std::string EscapeHTMLSpecialCharacters(std::string strMsg)
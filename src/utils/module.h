@@ -22,6 +22,7 @@
 #include "dbg.h"
 #include "interface.h"
 #include "plat.h"
+#include "sigscan.h"
 #include "strtools.h"
 
 #include <string>
@@ -50,21 +51,14 @@ public:
 
 	void* FindNext(bool allowWildcard)
 	{
-		for (size_t i = 0; i < m_iSize; i++)
-		{
-			size_t Matches = 0;
-			while (*(m_pCurrent + i + Matches) == m_pSignature[Matches] || (allowWildcard && m_pSignature[Matches] == '\x2A'))
-			{
-				Matches++;
-				if (Matches == m_iSigLength)
-				{
-					m_pCurrent += i + 1;
-					return m_pCurrent - 1;
-				}
-			}
-		}
+		CSignatureScanner scanner(m_pSignature, m_iSigLength, allowWildcard);
+		const byte* pMatch = scanner.FindNext(m_pCurrent, m_pBase + m_iSize);
 
-		return nullptr;
+		if (!pMatch)
+			return nullptr;
+
+		m_pCurrent = (byte*)pMatch + 1;
+		return (void*)pMatch;
 	}
 
 private:
@@ -108,38 +102,45 @@ public:
 		Message("Initialized module %s base: 0x%p | size: %d\n", m_pszModule, m_base, m_size);
 	}
 
-	void* FindSignature(const byte* pData, size_t iSigLength, int& error)
+	// Signatures are searched for in a single section, .text unless another one is given
+	// Falls back to the whole module if it doesn't have that section
+	void GetSignatureScanRange(const char* pszSection, const byte*& pBegin, const byte*& pEnd)
+	{
+		Section* pSection = GetSection(pszSection && pszSection[0] ? pszSection : ".text");
+
+		if (pSection)
+		{
+			pBegin = (byte*)pSection->m_pBase;
+			pEnd = pBegin + pSection->m_iSize;
+			return;
+		}
+
+		Warning("Section %s not found in %s, scanning the whole module\n", pszSection && pszSection[0] ? pszSection : ".text", m_pszModule);
+		pBegin = (byte*)m_base;
+		pEnd = pBegin + m_size;
+	}
+
+	void* FindSignature(const byte* pData, size_t iSigLength, int& error, const char* pszSection = nullptr)
 	{
-		unsigned char* pMemory;
-		void* return_addr = nullptr;
+		CSignatureScanner scanner(pData, iSigLength, true);
+		const byte* pMemory;
+		const byte* pEnd;
+		GetSignatureScanRange(pszSection, pMemory, pEnd);
 		error = 0;
 
-		pMemory = (byte*)m_base;
+		const byte* pMatch = scanner.FindNext(pMemory, pEnd);
 
-		for (size_t i = 0; i < m_size; i++)
+		if (!pMatch)
 		{
-			size_t Matches = 0;
-			while (i + Matches < m_size && (*(pMemory + i + Matches) == pData[Matches] || pData[Matches] == '\x2A'))
-			{
-				Matches++;
-				if (Matches == iSigLength)
-				{
-					if (return_addr)
-					{
-						error = SIG_FOUND_MULTIPLE;
-						return return_addr;
-					}
-
-					return_addr = (void*)(pMemory + i);
-					break;
-				}
-			}
+			error = SIG_NOT_FOUND;
+			return nullptr;
 		}
 
-		if (!return_addr)
-			error = SIG_NOT_FOUND;
+		// Keep going past the first match, a signature that isn't unique can't be trusted
+		if (scanner.FindNext(pMatch + 1, pEnd))
+			error = SIG_FOUND_MULTIPLE;
 
-		return return_addr;
+		return (void*)pMatch;
 	}
 
 	void* FindInterface(const char* name)
@@ -172,6 +173,9 @@ public:
 #endif
 	void* FindVirtualTable(const std::string& name);
 
+	// Hex string that identifies this exact build of the module, empty if the module doesn't carry one
+	std::string GetBuildId();
+
 public:
 	const char* m_pszModule;
 	const char* m_pszPath;
@@ -254,4 +254,32 @@ void* CModule::FindVirtualTable(const std::string& name)
 	Warning("Failed to find vtable for %s\n", name.c_str());
 	return nullptr;
 }
+
+std::string CModule::GetBuildId()
+{
+	auto buildIdNote = GetSection(".note.gnu.build-id");
+
+	if (!buildIdNote || buildIdNote->m_iSize < sizeof(ElfW(Nhdr)))
+		return "";
+
+	ElfW(Nhdr)* pNote = reinterpret_cast<ElfW(Nhdr)*>(buildIdNote->m_pBase);
+
+	// The note name ("GNU") is padded to 4 bytes, the ID itself comes right after it
+	size_t nDescOffset = sizeof(ElfW(Nhdr)) + ((pNote->n_namesz + 3) & ~3);
+
+	if (pNote->n_type != NT_GNU_BUILD_ID || nDescOffset + pNote->n_descsz > buildIdNote->m_iSize)
+		return "";
+
+	const uint8_t* pDesc = reinterpret_cast<const uint8_t*>(pNote) + nDescOffset;
+	std::string buildId;
+
+	for (size_t i = 0; i < pNote->n_descsz; i++)
+	{
+		char szByte[3];
+		V_snprintf(szByte, sizeof(szByte), "%02x", pDesc[i]);
+		buildId += szByte;
+	}
+
+	return buildId;
+}
 #endif
@@ -112,4 +112,38 @@ void* CModule::FindVirtualTable(const std::string& name)
 
 	Warning("Failed to find RTTI Complete Object Locator for %s\n", name.c_str());
 	return nullptr;
-}
\ No newline at end of file
+}
+
+std::string CModule::GetBuildId()
+{
+	IMAGE_DOS_HEADER* pDosHeader = reinterpret_cast<IMAGE_DOS_HEADER*>(m_hModule);
+	IMAGE_NT_HEADERS* pNtHeader = reinterpret_cast<IMAGE_NT_HEADERS64*>(reinterpret_cast<uintptr_t>(m_hModule) + pDosHeader->e_lfanew);
+
+	IMAGE_DATA_DIRECTORY& debugDirectory = pNtHeader->OptionalHeader.DataDirectory[IMAGE_DIRECTORY_ENTRY_DEBUG];
+	IMAGE_DEBUG_DIRECTORY* pDebugEntries = reinterpret_cast<IMAGE_DEBUG_DIRECTORY*>((uint8_t*)m_base + debugDirectory.VirtualAddress);
+
+	for (size_t i = 0; i < debugDirectory.Size / sizeof(IMAGE_DEBUG_DIRECTORY); i++)
+	{
+		if (pDebugEntries[i].Type != IMAGE_DEBUG_TYPE_CODEVIEW || pDebugEntries[i].SizeOfData < 24)
+			continue;
+
+		// CodeView RSDS record: signature, PDB GUID and age, the same pair symbol servers use to identify a build
+		const uint8_t* pCodeView = (uint8_t*)m_base + pDebugEntries[i].AddressOfRawData;
+
+		if (memcmp(pCodeView, "RSDS", 4) != 0)
+			continue;
+
+		std::string buildId;
+
+		for (size_t j = 4; j < 24; j++)
+		{
+			char szByte[3];
+			V_snprintf(szByte, sizeof(szByte), "%02x", pCodeView[j]);
+			buildId += szByte;
+		}
+
+		return buildId;
+	}
+
+	return "";
+}
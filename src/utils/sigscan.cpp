@@ -0,0 +1,360 @@
+/**
+ * =============================================================================
+ * CS2Fixes
+ * Copyright (C) 2023-2025 Source2ZE
+ * =============================================================================
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License, version 3.0, as published by the
+ * Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "sigscan.h"
+
+#include <algorithm>
+#include <thread>
+
+#if defined(__x86_64__) || defined(_M_X64)
+	#define SIGSCAN_X64
+	#include <immintrin.h>
+
+	#ifdef _MSC_VER
+		#include <intrin.h>
+		#define SIGSCAN_TARGET_AVX2
+	#else
+		#define SIGSCAN_TARGET_AVX2 __attribute__((target("avx2")))
+	#endif
+#endif
+
+// The offline gamedata checker builds this without the SDK
+#ifndef CS2FIXES_STANDALONE_TOOL
+	#include "tier0/memdbgon.h"
+#endif
+
+// How common each byte is in x86-64 code, higher is more common and makes a worse anchor
+// Rough order taken from byte histograms of libserver.so/server.dll, anything not listed is treated as rare
+static int GetByteFrequency(uint8_t nByte)
+{
+	static constexpr uint8_t s_commonBytes[] = {
+		0x00, 0xFF, 0x48, 0x8B, 0x89, 0x24, 0x0F, 0x41, 0x4C, 0x44, 0xE8, 0x85, 0x49, 0x8D, 0x45, 0x01,
+		0x84, 0x74, 0x75, 0x83, 0xC0, 0x10, 0x08, 0x20, 0xCC, 0x90, 0x4D, 0x0D, 0x05, 0x18, 0xC3, 0x28,
+		0x30, 0x40, 0xE9, 0x66, 0x80, 0x38, 0xC7, 0x31, 0xF8, 0x02, 0x04, 0x03, 0x50, 0x5D, 0xEB, 0x11,
+	};
+
+	for (size_t i = 0; i < sizeof(s_commonBytes); i++)
+		if (s_commonBytes[i] == nByte)
+			return (int)(sizeof(s_commonBytes) - i);
+
+	return 0;
+}
+
+#ifdef SIGSCAN_X64
+static inline int CountTrailingZeros(uint32_t nValue)
+{
+	#ifdef _MSC_VER
+	unsigned long nIndex;
+	_BitScanForward(&nIndex, nValue);
+	return (int)nIndex;
+	#else
+	return __builtin_ctz(nValue);
+	#endif
+}
+
+static bool CPUSupportsAVX2()
+{
+	#ifdef _MSC_VER
+	int info[4];
+	__cpuid(info, 0);
+
+	if (info[0] < 7)
+		return false;
+
+	// AVX2 needs the OS to save the YMM registers too, not just the CPU bit
+	__cpuid(info, 1);
+
+	if (!(info[2] & (1 << 27)) || !(info[2] & (1 << 28)) || (_xgetbv(0) & 6) != 6)
+		return false;
+
+	__cpuidex(info, 7, 0);
+	return info[1] & (1 << 5);
+	#else
+	return __builtin_cpu_supports("avx2");
+	#endif
+}
+#endif
+
+CSignatureScanner::CSignatureScanner(const uint8_t* pPattern, size_t nLength, bool bAllowWildcard) :
+	m_vecPattern(pPattern, pPattern + nLength), m_vecMask(nLength), m_iAnchor(-1), m_bAnchorPair(false)
+{
+	for (size_t i = 0; i < nLength; i++)
+		m_vecMask[i] = (bAllowWildcard && pPattern[i] == '\x2A') ? 0x00 : 0xFF;
+
+	int iBestScore = INT32_MAX;
+
+	for (size_t i = 0; i < nLength; i++)
+	{
+		if (!m_vecMask[i])
+			continue;
+
+		bool bPair = i + 1 < nLength && m_vecMask[i + 1];
+
+		// A pair always filters better than a lone byte, so only fall back to one when there are no pairs at all
+		int iScore = bPair ? GetByteFrequency(pPattern[i]) + GetByteFrequency(pPattern[i + 1]) : 0x10000 + GetByteFrequency(pPattern[i]);
+
+		if (iScore < iBestScore)
+		{
+			iBestScore = iScore;
+			m_iAnchor = (int)i;
+			m_bAnchorPair = bPair;
+		}
+	}
+}
+
+bool CSignatureScanner::Matches(const uint8_t* pCandidate) const
+{
+	size_t nLength = m_vecPattern.size();
+	size_t i = 0;
+
+#ifdef SIGSCAN_X64
+	for (; i + 16 <= nLength; i += 16)
+	{
+		__m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pCandidate + i));
+		__m128i pattern = _mm_loadu_si128(reinterpret_cast<const __m128i*>(m_vecPattern.data() + i));
+		__m128i mask = _mm_loadu_si128(reinterpret_cast<const __m128i*>(m_vecMask.data() + i));
+		__m128i diff = _mm_and_si128(_mm_xor_si128(data, pattern), mask);
+
+		if (_mm_movemask_epi8(_mm_cmpeq_epi8(diff, _mm_setzero_si128())) != 0xFFFF)
+			return false;
+	}
+#endif
+
+	for (; i < nLength; i++)
+		if ((pCandidate[i] ^ m_vecPattern[i]) & m_vecMask[i])
+			return false;
+
+	return true;
+}
+
+const uint8_t* CSignatureScanner::FindNextScalar(const uint8_t* pBegin, const uint8_t* pEnd) const
+{
+	size_t nLength = m_vecPattern.size();
+
+	if ((size_t)(pEnd - pBegin) < nLength)
+		return nullptr;
+
+	uint8_t nAnchor = m_vecPattern[m_iAnchor];
+
+	for (const uint8_t* pCandidate = pBegin; pCandidate <= pEnd - nLength; pCandidate++)
+		if (pCandidate[m_iAnchor] == nAnchor && Matches(pCandidate))
+			return pCandidate;
+
+	return nullptr;
+}
+
+#ifdef SIGSCAN_X64
+const uint8_t* CSignatureScanner::FindNextSSE2(const uint8_t* pBegin, const uint8_t* pEnd) const
+{
+	size_t nLength = m_vecPattern.size();
+	const uint8_t* pCandidate = pBegin;
+
+	__m128i first = _mm_set1_epi8((char)m_vecPattern[m_iAnchor]);
+	__m128i second = _mm_set1_epi8(m_bAnchorPair ? (char)m_vecPattern[m_iAnchor + 1] : 0);
+
+	// Test 16 candidate starts at once, as long as all of them (and the anchor loads) stay within range
+	while ((size_t)(pEnd - pCandidate) >= nLength + 15)
+	{
+		const uint8_t* pAnchor = pCandidate + m_iAnchor;
+		uint32_t nHits = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pAnchor)), first));
+
+		if (nHits && m_bAnchorPair)
+			nHits &= _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pAnchor + 1)), second));
+
+		while (nHits)
+		{
+			const uint8_t* pMatch = pCandidate + CountTrailingZeros(nHits);
+
+			if (Matches(pMatch))
+				return pMatch;
+
+			nHits &= nHits - 1;
+		}
+
+		pCandidate += 16;
+	}
+
+	return FindNextScalar(pCandidate, pEnd);
+}
+
+SIGSCAN_TARGET_AVX2 const uint8_t* CSignatureScanner::FindNextAVX2(const uint8_t* pBegin, const uint8_t* pEnd) const
+{
+	size_t nLength = m_vecPattern.size();
+	const uint8_t* pCandidate = pBegin;
+
+	__m256i first = _mm256_set1_epi8((char)m_vecPattern[m_iAnchor]);
+	__m256i second = _mm256_set1_epi8(m_bAnchorPair ? (char)m_vecPattern[m_iAnchor + 1] : 0);
+
+	while ((size_t)(pEnd - pCandidate) >= nLength + 31)
+	{
+		const uint8_t* pAnchor = pCandidate + m_iAnchor;
+		uint32_t nHits = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(pAnchor)), first));
+
+		if (nHits && m_bAnchorPair)
+			nHits &= (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(pAnchor + 1)), second));
+
+		while (nHits)
+		{
+			const uint8_t* pMatch = pCandidate + CountTrailingZeros(nHits);
+
+			if (Matches(pMatch))
+				return pMatch;
+
+			nHits &= nHits - 1;
+		}
+
+		pCandidate += 32;
+	}
+
+	return FindNextSSE2(pCandidate, pEnd);
+}
+#endif
+
+const uint8_t* CSignatureScanner::FindNext(const uint8_t* pBegin, const uint8_t* pEnd) const
+{
+	if (m_vecPattern.empty() || pBegin >= pEnd || (size_t)(pEnd - pBegin) < m_vecPattern.size())
+		return nullptr;
+
+	// Nothing to compare, every position matches
+	if (m_iAnchor == -1)
+		return pBegin;
+
+#ifdef SIGSCAN_X64
+	static const bool s_bAVX2 = CPUSupportsAVX2();
+
+	if (s_bAVX2)
+		return FindNextAVX2(pBegin, pEnd);
+
+	return FindNextSSE2(pBegin, pEnd);
+#else
+	return FindNextScalar(pBegin, pEnd);
+#endif
+}
+
+int CMultiSignatureScanner::AddPattern(const uint8_t* pPattern, size_t nLength, bool bAllowWildcard)
+{
+	int iIndex = (int)m_vecScanners.size();
+	const CSignatureScanner& scanner = m_vecScanners.emplace_back(pPattern, nLength, bAllowWildcard);
+
+	if (!scanner.HasAnchorPair())
+	{
+		m_vecUnanchored.push_back(iIndex);
+		return iIndex;
+	}
+
+	uint16_t nPair = scanner.GetAnchorPair();
+	m_vecAnchorBitmap[nPair >> 6] |= 1ull << (nPair & 63);
+	m_mapAnchorPatterns[nPair].push_back(iIndex);
+
+	return iIndex;
+}
+
+void CMultiSignatureScanner::AddMatch(Result_t& result, const uint8_t* pMatch)
+{
+	if (!result.m_pFirst || pMatch < result.m_pFirst)
+		result.m_pFirst = pMatch;
+
+	result.m_nMatches = std::min(result.m_nMatches + 1, 2);
+}
+
+void CMultiSignatureScanner::ScanRange(const uint8_t* pBegin, const uint8_t* pEnd, const uint8_t* pRangeBegin, const uint8_t* pRangeEnd, std::vector<Result_t>& vecResults) const
+{
+	// The pair read below needs one byte past the anchor
+	pRangeEnd = std::min(pRangeEnd, pEnd - 1);
+
+	for (const uint8_t* pAnchor = pRangeBegin; pAnchor < pRangeEnd; pAnchor++)
+	{
+		uint16_t nPair = pAnchor[0] | (pAnchor[1] << 8);
+
+		if (!(m_vecAnchorBitmap[nPair >> 6] & (1ull << (nPair & 63))))
+			continue;
+
+		for (int iIndex : m_mapAnchorPatterns.at(nPair))
+		{
+			const CSignatureScanner& scanner = m_vecScanners[iIndex];
+			const uint8_t* pCandidate = pAnchor - scanner.GetAnchor();
+
+			if (pAnchor - pBegin < scanner.GetAnchor() || (size_t)(pEnd - pCandidate) < scanner.GetLength())
+				continue;
+
+			if (scanner.Matches(pCandidate))
+				AddMatch(vecResults[iIndex], pCandidate);
+		}
+	}
+}
+
+std::vector<CMultiSignatureScanner::Result_t> CMultiSignatureScanner::Scan(const uint8_t* pBegin, const uint8_t* pEnd, int nThreads) const
+{
+	std::vector<Result_t> vecResults(m_vecScanners.size(), Result_t{nullptr, 0});
+
+	if (pEnd <= pBegin)
+		return vecResults;
+
+	if (!m_mapAnchorPatterns.empty())
+	{
+		size_t nSize = pEnd - pBegin;
+		nThreads = std::clamp(nThreads, 1, (int)std::max<size_t>(nSize / (1 << 20), 1)); // Not worth a thread per less than 1MB
+		size_t nChunkSize = (nSize + nThreads - 1) / nThreads;
+
+		std::vector<std::vector<Result_t>> vecThreadResults(nThreads, vecResults);
+		std::vector<std::thread> vecThreads;
+
+		for (int i = 1; i < nThreads; i++)
+		{
+			const uint8_t* pRangeBegin = pBegin + std::min(nSize, i * nChunkSize);
+			const uint8_t* pRangeEnd = pBegin + std::min(nSize, (i + 1) * nChunkSize);
+
+			vecThreads.emplace_back([this, pBegin, pEnd, pRangeBegin, pRangeEnd, &vecThreadResults, i]() {
+				ScanRange(pBegin, pEnd, pRangeBegin, pRangeEnd, vecThreadResults[i]);
+			});
+		}
+
+		ScanRange(pBegin, pEnd, pBegin, pBegin + std::min(nSize, nChunkSize), vecThreadResults[0]);
+
+		for (auto& thread : vecThreads)
+			thread.join();
+
+		for (const auto& vecThreadResult : vecThreadResults)
+		{
+			for (size_t i = 0; i < vecResults.size(); i++)
+			{
+				if (!vecThreadResult[i].m_pFirst)
+					continue;
+
+				AddMatch(vecResults[i], vecThreadResult[i].m_pFirst);
+
+				if (vecThreadResult[i].m_nMatches > 1)
+					vecResults[i].m_nMatches = 2;
+			}
+		}
+	}
+
+	for (int iIndex : m_vecUnanchored)
+	{
+		const CSignatureScanner& scanner = m_vecScanners[iIndex];
+		const uint8_t* pMatch = scanner.FindNext(pBegin, pEnd);
+
+		if (!pMatch)
+			continue;
+
+		vecResults[iIndex] = {pMatch, scanner.FindNext(pMatch + 1, pEnd) ? 2 : 1};
+	}
+
+	return vecResults;
+}
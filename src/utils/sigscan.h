@@ -0,0 +1,93 @@
+/**
+ * =============================================================================
+ * CS2Fixes
+ * Copyright (C) 2023-2025 Source2ZE
+ * =============================================================================
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License, version 3.0, as published by the
+ * Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// Vectorized byte pattern search used by CModule::FindSignature and SignatureIterator
+// Candidates are found by comparing the rarest adjacent pair of fixed bytes in the pattern 16/32 bytes at a time,
+// then each candidate is verified against the whole pattern with masked compares
+class CSignatureScanner
+{
+public:
+	// '\x2A' bytes in the pattern match anything if bAllowWildcard is set
+	CSignatureScanner(const uint8_t* pPattern, size_t nLength, bool bAllowWildcard);
+
+	// First match that lies completely within [pBegin, pEnd), or nullptr
+	const uint8_t* FindNext(const uint8_t* pBegin, const uint8_t* pEnd) const;
+
+	// Whether the pattern matches at exactly this address, the caller makes sure it's in range
+	bool Matches(const uint8_t* pCandidate) const;
+
+	size_t GetLength() const { return m_vecPattern.size(); }
+	int GetAnchor() const { return m_iAnchor; }
+	bool HasAnchorPair() const { return m_bAnchorPair; }
+
+	// The anchor pair as a little endian 16 bit value, only meaningful if HasAnchorPair
+	uint16_t GetAnchorPair() const { return m_vecPattern[m_iAnchor] | (m_vecPattern[m_iAnchor + 1] << 8); }
+
+private:
+	const uint8_t* FindNextScalar(const uint8_t* pBegin, const uint8_t* pEnd) const;
+	const uint8_t* FindNextSSE2(const uint8_t* pBegin, const uint8_t* pEnd) const;
+	const uint8_t* FindNextAVX2(const uint8_t* pBegin, const uint8_t* pEnd) const;
+
+	std::vector<uint8_t> m_vecPattern;
+	std::vector<uint8_t> m_vecMask; // 0xFF for bytes that have to match, 0x00 for wildcards
+
+	// Offset of the anchor pair within the pattern, -1 if every byte is a wildcard
+	int m_iAnchor;
+
+	// Whether the anchor is a real pair or a single fixed byte with nothing fixed next to it
+	bool m_bAnchorPair;
+};
+
+// Looks for many patterns in a single pass over an image instead of one pass per pattern
+// Every position's byte pair is checked against a bitmap of all anchor pairs, and only patterns anchored on a hit are verified
+class CMultiSignatureScanner
+{
+public:
+	struct Result_t
+	{
+		const uint8_t* m_pFirst;
+		int m_nMatches; // Capped at 2, that's enough to tell a unique signature from an ambiguous one
+	};
+
+	// Returns the index of the pattern in Scan's results
+	int AddPattern(const uint8_t* pPattern, size_t nLength, bool bAllowWildcard);
+
+	// Scans [pBegin, pEnd) for every pattern, with the image split between up to nThreads threads
+	std::vector<Result_t> Scan(const uint8_t* pBegin, const uint8_t* pEnd, int nThreads) const;
+
+private:
+	// Checks the anchors starting in [pRangeBegin, pRangeEnd), matches themselves may extend anywhere within [pBegin, pEnd)
+	void ScanRange(const uint8_t* pBegin, const uint8_t* pEnd, const uint8_t* pRangeBegin, const uint8_t* pRangeEnd, std::vector<Result_t>& vecResults) const;
+
+	static void AddMatch(Result_t& result, const uint8_t* pMatch);
+
+	std::vector<CSignatureScanner> m_vecScanners;
+	std::vector<uint64_t> m_vecAnchorBitmap = std::vector<uint64_t>(65536 / 64);
+	std::unordered_map<uint16_t, std::vector<int>> m_mapAnchorPatterns;
+
+	// Patterns without two adjacent fixed bytes, these get a pass of their own
+	std::vector<int> m_vecUnanchored;
+};
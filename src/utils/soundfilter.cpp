@@ -0,0 +1,81 @@
+/**
+ * =============================================================================
+ * CS2Fixes
+ * Copyright (C) 2023-2025 Source2ZE
+ * =============================================================================
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License, version 3.0, as published by the
+ * Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "soundfilter.h"
+#include "common.h"
+#include "cs2fixes.h"
+#include "vendor/nlohmann/json.hpp"
+#include <algorithm>
+#include <fstream>
+
+#include "tier0/memdbgon.h"
+
+using ordered_json = nlohmann::ordered_json;
+
+void CSoundEventFilter::AddSoundEvent(const char* pszSoundEventName)
+{
+	m_vecHashes.push_back(GetSoundEventHash(pszSoundEventName));
+}
+
+bool CSoundEventFilter::AddFromConfig(const char* pszJsonPath)
+{
+	char szPath[MAX_PATH];
+	V_snprintf(szPath, sizeof(szPath), "%s%s%s", Plat_GetGameDirectory(), "/csgo/", pszJsonPath);
+	std::ifstream jsonFile(szPath);
+
+	// The config is optional
+	if (!jsonFile.is_open())
+		return true;
+
+	ordered_json jConfig = ordered_json::parse(jsonFile, nullptr, false, true);
+
+	if (jConfig.is_discarded() || !jConfig.is_object())
+	{
+		Panic("Failed parsing JSON from %s\n", pszJsonPath);
+		return false;
+	}
+
+	ordered_json jSoundEvents = jConfig.value("SoundEvents", ordered_json::array());
+
+	if (!jSoundEvents.is_array())
+	{
+		Panic("\"SoundEvents\" in %s must be an array\n", pszJsonPath);
+		return false;
+	}
+
+	for (const auto& jSoundEvent : jSoundEvents)
+	{
+		if (!jSoundEvent.is_string())
+		{
+			Warning("Skipping non-string sound event in %s\n", pszJsonPath);
+			continue;
+		}
+
+		AddSoundEvent(jSoundEvent.get<std::string>().c_str());
+	}
+
+	return true;
+}
+
+void CSoundEventFilter::Finalize()
+{
+	std::sort(m_vecHashes.begin(), m_vecHashes.end());
+	m_vecHashes.erase(std::unique(m_vecHashes.begin(), m_vecHashes.end()), m_vecHashes.end());
+}
@@ -0,0 +1,61 @@
+/**
+ * =============================================================================
+ * CS2Fixes
+ * Copyright (C) 2023-2025 Source2ZE
+ * =============================================================================
+ *
+ * This program is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License, version 3.0, as published by the
+ * Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include "platform.h"
+#include <vector>
+
+// Set of sound event hashes stored as a sorted flat array, lookups are a branchless binary search over a few cache lines
+class CSoundEventFilter
+{
+public:
+	void Clear() { m_vecHashes.clear(); }
+	void AddSoundEvent(const char* pszSoundEventName);
+
+	// Adds every name in the "SoundEvents" array of a jsonc file, returns false if it exists but can't be parsed
+	bool AddFromConfig(const char* pszJsonPath);
+
+	// Must be called after adding sound events and before any lookup
+	void Finalize();
+
+	bool Contains(uint32 nHash) const
+	{
+		const uint32* pBase = m_vecHashes.data();
+		size_t nCount = m_vecHashes.size();
+
+		if (!nCount)
+			return false;
+
+		while (nCount > 1)
+		{
+			size_t nHalf = nCount / 2;
+			pBase = pBase[nHalf] <= nHash ? pBase + nHalf : pBase;
+			nCount -= nHalf;
+		}
+
+		return *pBase == nHash;
+	}
+
+	int Count() const { return m_vecHashes.size(); }
+
+private:
+	std::vector<uint32> m_vecHashes;
+};
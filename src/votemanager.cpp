@@ -53,15 +53,15 @@ void CVoteManager::VoteManager_Init()
 		if (m_ExtendState < EExtendState::POST_EXTEND_NO_EXTENDS_LEFT)
 			m_ExtendState = EExtendState::EXTEND_ALLOWED;
 		return -1.0f;
-	});
+	}, "votemanager/extend_delay");
 
 	CTimer::Create(g_cvarRtvDelay.Get(), TIMERFLAG_MAP, [this]() {
 		if (m_RTVState != ERTVState::BLOCKED_BY_ADMIN)
 			m_RTVState = ERTVState::RTV_ALLOWED;
 		return -1.0f;
-	});
+	}, "votemanager/rtv_delay");
 
-	CTimer::Create(m_flExtendVoteTickrate, TIMERFLAG_MAP, std::bind(&CVoteManager::TimerCheckTimeleft, this));
+	CTimer::Create(m_flExtendVoteTickrate, TIMERFLAG_MAP, std::bind(&CVoteManager::TimerCheckTimeleft, this), "votemanager/timeleft");
 }
 
 float CVoteManager::TimerCheckTimeleft()
@@ -111,7 +111,7 @@ float CVoteManager::TimerCheckTimeleft()
 		ClientPrintAll(HUD_PRINTTALK, CHAT_PREFIX "Extend vote starting in %d....", m_iVoteStartTicks);
 		m_iVoteStartTicks--;
 		return 1.0f;
-	});
+	}, "votemanager/extend_start");
 
 	return m_flExtendVoteTickrate;
 }
@@ -632,7 +632,7 @@ bool CVoteManager::VoteExtendEndCallback(YesNoVoteInfo info)
 				CTimer::Create(0.1, TIMERFLAG_MAP, [this]() {
 					m_ExtendState = EExtendState::EXTEND_ALLOWED;
 					return -1.0f;
-				});
+				}, "votemanager/extend_auto");
 			}
 			else
 			{
@@ -643,7 +643,7 @@ bool CVoteManager::VoteExtendEndCallback(YesNoVoteInfo info)
 					if (m_ExtendState == EExtendState::POST_EXTEND_COOLDOWN)
 						m_ExtendState = EExtendState::EXTEND_ALLOWED;
 					return -1.0f;
-				});
+				}, "votemanager/extend_cooldown");
 			}
 		}
 
@@ -683,7 +683,7 @@ void CVoteManager::StartExtendVote(int iCaller)
 		ClientPrintAll(HUD_PRINTTALK, CHAT_PREFIX "Extend vote ending in %d....", m_iVoteEndTicks);
 		m_iVoteEndTicks--;
 		return 1.0f;
-	});
+	}, "votemanager/extend_end");
 }
 
 void CVoteManager::OnIntermission()
@@ -716,7 +716,7 @@ bool CVoteManager::CheckRTVStatus()
 				g_pGameRules->TerminateRound(5.0f, CSRoundEndReason::Draw);
 
 				return -1.0f;
-			});
+			}, "votemanager/rtv_end");
 		}
 		else
 		{
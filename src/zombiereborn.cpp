@@ -30,15 +30,18 @@
 #include "eventlistener.h"
 #include "hud_manager.h"
 #include "leader.h"
+#include "netevents.h"
 #include "networksystem/inetworkmessages.h"
 #include "playermanager.h"
 #include "recipientfilters.h"
 #include "serversideclient.h"
+#include "soundfilter.h"
 #include "tier0/vprof.h"
 #include "user_preferences.h"
 #include "utils/entity.h"
 #include "vendor/nlohmann/json.hpp"
 #include "zombiereborn.h"
+#include <bit>
 #include <fstream>
 #include <sstream>
 
@@ -542,7 +545,7 @@ void CZRPlayerClassManager::ApplyHumanClass(std::shared_ptr<ZRHumanClass> pClass
 			if (pPawn)
 				Leader_ApplyLeaderVisuals(pPawn);
 			return -1.0f;
-		});
+		}, "zr/leader_spawn");
 	}
 }
 
@@ -682,7 +685,7 @@ void CZRPlayerClassManager::CreateRegenTimer(int iPlayerSlot, CHandle<CCSPlayerP
 	// Double check a regen timer isn't somehow already running
 	CancelRegenTimer(iPlayerSlot);
 
-	auto wTimer = CTimer::Create(flInterval, TIMERFLAG_MAP | TIMERFLAG_ROUND, [hPawn, flInterval, iAmount]() {
+	auto hTimer = CTimer::Create(flInterval, TIMERFLAG_MAP | TIMERFLAG_ROUND, [hPawn, flInterval, iAmount]() {
 		CCSPlayerPawn* pPawn = hPawn.Get();
 
 		if (!pPawn || !pPawn->IsAlive())
@@ -695,9 +698,9 @@ void CZRPlayerClassManager::CreateRegenTimer(int iPlayerSlot, CHandle<CCSPlayerP
 		int iHealth = pPawn->m_iHealth() + iAmount;
 		pPawn->m_iHealth = pPawn->m_iMaxHealth() < iHealth ? pPawn->m_iMaxHealth() : iHealth;
 		return flInterval;
-	});
+	}, "zr/regen");
 
-	m_vecRegenTimers[iPlayerSlot] = wTimer;
+	m_vecRegenTimers[iPlayerSlot] = hTimer;
 }
 
 void CZRPlayerClassManager::CancelRegenTimer(int iPlayerSlot)
@@ -705,10 +708,7 @@ void CZRPlayerClassManager::CancelRegenTimer(int iPlayerSlot)
 	if (iPlayerSlot < 0 || iPlayerSlot > 63)
 		return;
 
-	auto wTimer = m_vecRegenTimers[iPlayerSlot];
-
-	if (!wTimer.expired())
-		wTimer.lock()->Cancel();
+	m_vecRegenTimers[iPlayerSlot].Cancel();
 }
 
 void ZR_OnLevelInit()
@@ -726,7 +726,7 @@ void ZR_OnLevelInit()
 		g_pEngineServer2->ServerCommand("mp_autoteambalance 0");
 
 		return -1.0f;
-	});
+	}, "zr/level_init");
 
 	g_pZRWeaponConfig->LoadWeaponConfig();
 	g_pZRHitgroupConfig->LoadHitgroupConfig();
@@ -986,7 +986,7 @@ void ZR_OnPlayerSpawn(CCSPlayerController* pController)
 		else
 			ZR_Cure(pController);
 		return -1.0f;
-	});
+	}, "zr/spawn");
 }
 
 void ZR_ApplyKnockback(CCSPlayerPawn* pHuman, CCSPlayerPawn* pVictim, int iDamage, const char* szWeapon, int hitgroup, float classknockback)
@@ -1206,7 +1206,7 @@ void ZR_Infect(CCSPlayerController* pAttackerController, CCSPlayerController* pV
 		pZEPlayer->SetInfectState(true);
 
 		ZEPlayerHandle hPlayer = pZEPlayer->GetHandle();
-		CTimer::Create(rand() % (int)g_cvarMoanInterval.Get(), TIMERFLAG_MAP | TIMERFLAG_ROUND, [hPlayer]() { return ZR_MoanTimer(hPlayer); });
+		CTimer::Create(rand() % (int)g_cvarMoanInterval.Get(), TIMERFLAG_MAP | TIMERFLAG_ROUND, [hPlayer]() { return ZR_MoanTimer(hPlayer); }, "zr/moan");
 	}
 }
 
@@ -1247,7 +1247,7 @@ void ZR_InfectMotherZombie(CCSPlayerController* pVictimController, std::vector<S
 	pZEPlayer->SetInfectState(true);
 
 	ZEPlayerHandle hPlayer = pZEPlayer->GetHandle();
-	CTimer::Create(rand() % (int)g_cvarMoanInterval.Get(), TIMERFLAG_MAP | TIMERFLAG_ROUND, [hPlayer]() { return ZR_MoanTimer(hPlayer); });
+	CTimer::Create(rand() % (int)g_cvarMoanInterval.Get(), TIMERFLAG_MAP | TIMERFLAG_ROUND, [hPlayer]() { return ZR_MoanTimer(hPlayer); }, "zr/moan");
 }
 
 // make players who've been picked as MZ recently less likely to be picked again
@@ -1262,17 +1262,14 @@ void ZR_InitialInfection()
 
 	// mz infection candidates
 	CUtlVector<CCSPlayerController*> pCandidateControllers;
-	for (int i = 0; i < GetGlobals()->maxClients; i++)
-	{
-		CCSPlayerController* pController = CCSPlayerController::FromSlot(i);
-		if (!pController || !pController->IsConnected() || pController->m_iTeamNum() != CS_TEAM_CT)
-			continue;
+	uint64 iCandidateMask = g_playerManager->GetConnectedMask() & g_playerManager->GetAliveMask() & g_playerManager->GetTeamMask(CS_TEAM_CT);
+	pCandidateControllers.EnsureCapacity(std::popcount(iCandidateMask));
 
-		CCSPlayerPawn* pPawn = (CCSPlayerPawn*)pController->GetPawn();
-		if (!pPawn || !pPawn->IsAlive())
-			continue;
-
-		pCandidateControllers.AddToTail(pController);
+	for (; iCandidateMask; iCandidateMask &= iCandidateMask - 1)
+	{
+		CCSPlayerController* pController = CCSPlayerController::FromSlot(std::countr_zero(iCandidateMask));
+		if (pController)
+			pCandidateControllers.AddToTail(pController);
 	}
 
 	if (g_cvarInfectSpawnMZRatio.Get() <= 0)
@@ -1403,7 +1400,7 @@ void ZR_StartInitialCountdown()
 		(*iSecondsElapsed)++;
 
 		return 1.0f;
-	});
+	}, "zr/infection_countdown");
 }
 
 bool ZR_Hook_OnTakeDamage_Alive(CTakeDamageInfo* pInfo, CCSPlayerPawn* pVictimPawn)
@@ -1519,7 +1516,7 @@ void SpawnPlayer(CCSPlayerController* pController)
 			return -1.0f;
 		pController->Respawn();
 		return -1.0f;
-	});
+	}, "zr/respawn_check");
 }
 
 void ZR_Hook_ClientPutInServer(CPlayerSlot slot, char const* pszName, int type, uint64 xuid)
@@ -1623,7 +1620,7 @@ void ZR_OnPlayerDeath(IGameEvent* pEvent)
 			return -1.0f;
 		pController->Respawn();
 		return -1.0f;
-	});
+	}, "zr/respawn");
 }
 
 void ZR_OnRoundFreezeEnd(IGameEvent* pEvent)
@@ -1639,22 +1636,13 @@ void ZR_OnRoundTimeWarning(IGameEvent* pEvent)
 			return -1.0f;
 		ZR_EndRoundAndAddTeamScore(g_cvarDefaultWinnerTeam.Get());
 		return -1.0f;
-	});
+	}, "zr/round_time_warning");
 }
 
 // check whether players on a team are all dead
 bool ZR_IsTeamAlive(int iTeamNum)
 {
-	CCSPlayerPawn* pPawn = nullptr;
-	while (nullptr != (pPawn = (CCSPlayerPawn*)UTIL_FindEntityByClassname(pPawn, "player")))
-	{
-		if (!pPawn->IsAlive())
-			continue;
-
-		if (pPawn->m_iTeamNum() == iTeamNum)
-			return true;
-	}
-	return false;
+	return g_playerManager->GetAliveMask() & g_playerManager->GetTeamMask(iTeamNum);
 }
 
 // check whether a team has won the round, if so, end the round and incre score
@@ -1752,19 +1740,25 @@ void ZR_EndRoundAndAddTeamScore(int iTeamNum)
 	}
 }
 
-void ZR_PostEventAbstract_SosStartSoundEvent(const uint64* pClients, CNetMessagePB<CMsgSosStartSoundEvent>* pMsg)
+POST_EVENT_F(GE_SosStartSoundEvent)
 {
-	static std::set<uint32> soundEventHashes;
+	if (!g_cvarEnableZR.Get())
+		return;
+
+	auto pMsg = const_cast<CNetMessage*>(context.pData)->ToPB<CMsgSosStartSoundEvent>();
+
+	static CSoundEventFilter zombieSoundFilter;
 
 	ExecuteOnce(
-		soundEventHashes.insert(GetSoundEventHash("zr.amb.scream"));
-		soundEventHashes.insert(GetSoundEventHash("zr.amb.zombie_die"));
-		soundEventHashes.insert(GetSoundEventHash("zr.amb.zombie_pain"));
-		soundEventHashes.insert(GetSoundEventHash("zr.amb.zombie_voice_idle")););
+		zombieSoundFilter.AddSoundEvent("zr.amb.scream");
+		zombieSoundFilter.AddSoundEvent("zr.amb.zombie_die");
+		zombieSoundFilter.AddSoundEvent("zr.amb.zombie_pain");
+		zombieSoundFilter.AddSoundEvent("zr.amb.zombie_voice_idle");
+		zombieSoundFilter.Finalize(););
 
 	// Filter out people with zsounds disabled from hearing this sound
-	if (soundEventHashes.contains(pMsg->soundevent_hash()))
-		*(uint64*)pClients &= g_playerManager->GetZSoundsMask();
+	if (zombieSoundFilter.Contains(pMsg->soundevent_hash()))
+		*context.pClients &= g_playerManager->GetZSoundsMask();
 }
 
 CON_COMMAND_CHAT(zsounds, "- Toggle zombie sounds")
@@ -1855,7 +1849,7 @@ CON_COMMAND_CHAT(ztele, "- Teleport to spawn")
 		}
 
 		return -1.0f;
-	});
+	}, "zr/ztele");
 }
 
 CON_COMMAND_CHAT(zclass, "<teamname/class name/number> - Find and select your Z:R classes")
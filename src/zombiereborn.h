@@ -224,7 +224,7 @@ private:
 	// These exist so we can iterate the class maps in insertion order
 	std::vector<uint32> m_ZombieClassKeys;
 	std::vector<uint32> m_HumanClassKeys;
-	std::weak_ptr<CTimer> m_vecRegenTimers[MAXPLAYERS];
+	CTimerHandle m_vecRegenTimers[MAXPLAYERS];
 };
 
 extern CZRPlayerClassManager* g_pZRPlayerClassManager;
@@ -277,5 +277,4 @@ void ZR_Detour_CEntityIdentity_AcceptInput(CEntityIdentity* pThis, CUtlSymbolLar
 void ZR_Hook_ClientPutInServer(CPlayerSlot slot, char const* pszName, int type, uint64 xuid);
 void ZR_Hook_ClientCommand_JoinTeam(CPlayerSlot slot, const CCommand& args);
 void ZR_Precache(IEntityResourceManifest* pResourceManifest);
-bool ZR_CheckTeamWinConditions(int iTeamNum);
-void ZR_PostEventAbstract_SosStartSoundEvent(const uint64* pClients, CNetMessagePB<CMsgSosStartSoundEvent>* pMsg);
\ No newline at end of file
+bool ZR_CheckTeamWinConditions(int iTeamNum);
\ No newline at end of file